@@ -0,0 +1,83 @@
+/* future event list benchmark: hold model (pop the earliest event,
+ * schedule a new one a little later) over the backends in fel.c,
+ * with the short, clustered delays of the simulators:
+ * transfers (send_data < 30) and runs (workload/level)
+ *
+ * usage: fel-bench [pending events ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "fel.h"
+
+/* hold operations timed for each size */
+#define HOLDS 2000000
+
+/* function declaration */
+long int delay();
+double hold();
+
+unsigned long int seed = 1;
+
+int main(int argc, char *argv[])
+{
+	static long int sizes[] = { 1000, 100000, 10000000 };
+	int kinds[] = { FEL_HEAP, FEL_CALENDAR, FEL_WHEEL };
+	long int n;
+	int i, k, count;
+
+	count = (argc > 1) ? argc - 1 : 3;
+	printf("%10s %10s %10s %10s\n", "pending", "heap", "calendar", "wheel");
+	for (i=0;i<count;++i) {
+		n = (argc > 1) ? atol(argv[i+1]) : sizes[i];
+		printf("%10li", n);
+		for (k=0;k<3;++k) {
+			printf(" %8.1fns", hold(kinds[k], n));
+			fflush(stdout);
+		}
+		printf("\n");
+	}
+	return 0;
+}
+
+/* delay of a transfer or a run, as the simulators produce them */
+long int delay()
+{
+	long int workload, level;
+
+	seed = seed*6364136223846793005UL + 1442695040888963407UL;
+	if ((seed >> 33) & 1)
+		return ((seed >> 40) % 30 > 1) ? (seed >> 40) % 30 : 1;
+	workload = 50 + (seed >> 20) % 950;
+	level = 1 + (seed >> 50) % 5;
+	return (workload + level - 1)/level;
+}
+
+/* nanoseconds per hold operation with n pending events */
+double hold(int kind, long int n)
+{
+	struct fel q;
+	struct event e;
+	struct timespec t0, t1;
+	long int i, last;
+
+	if (fel_init(&q, kind)) return 0;
+	seed = 1;
+	for (i=0;i<n;++i) fel_insert(&q, delay(), NULL);
+
+	last = 0;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i=0;i<HOLDS;++i) {
+		fel_pop(&q, &e);
+		if (e.time < last) {
+			fprintf(stderr, "%s: event %li popped after %li\n", fel_name(kind), e.time, last);
+			exit(1);
+		}
+		last = e.time;
+		fel_insert(&q, e.time + delay(), NULL);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	fel_free(&q);
+	return ((t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec))/HOLDS;
+}
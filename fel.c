@@ -0,0 +1,436 @@
+/* future event list backends:
+ * binary heap, calendar queue (R. Brown, 1988) and hierarchical timing wheel */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "fel.h"
+
+/* fel_node slab size */
+#define NODE_SLAB 4096
+
+/* calendar queue events sampled to size the buckets */
+#define CQ_SAMPLE 25
+
+/* function declaration */
+static int heap_insert(struct fel *q, long int time, void *data);
+static int heap_pop(struct fel *q, struct event *e);
+static int cq_resize(struct fel *q, long int nb);
+static int cq_insert(struct fel *q, long int time, void *data);
+static int cq_pop(struct fel *q, struct event *e);
+static int cmp_node_time(const void *a, const void *b);
+static long int cq_locate(struct fel *q);
+static int wheel_insert(struct fel *q, long int time, void *data);
+static void wheel_place(struct fel *q, struct fel_node *n);
+static long int wheel_min(struct fel *q);
+static int wheel_pop(struct fel *q, struct event *e);
+static int next_used(struct fel *q, int level, int s);
+
+int fel_kind(const char *name)
+{
+	if (!strcmp(name,"heap")) return FEL_HEAP;
+	if (!strcmp(name,"calendar")) return FEL_CALENDAR;
+	if (!strcmp(name,"wheel")) return FEL_WHEEL;
+	return 0;
+}
+
+const char *fel_name(int kind)
+{
+	switch (kind) {
+	case FEL_HEAP:
+		return "heap";
+	case FEL_CALENDAR:
+		return "calendar";
+	case FEL_WHEEL:
+		return "wheel";
+	default:
+		return NULL;
+	}
+}
+
+/* returns 0 on success, -1 if kind is unknown or out of memory */
+int fel_init(struct fel *q, int kind)
+{
+	memset(q, 0, sizeof(struct fel));
+	q->kind = kind;
+	pool_init(&q->nodes, sizeof(struct fel_node), NODE_SLAB);
+	switch (kind) {
+	case FEL_HEAP:
+		q->heap_max = 1024;
+		if ( !(q->heap = malloc(q->heap_max*sizeof(struct event))) ) return -1;
+		return 0;
+	case FEL_CALENDAR:
+		q->width = 1;
+		return cq_resize(q, 2);
+	case FEL_WHEEL:
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+void fel_free(struct fel *q)
+{
+	free(q->heap);
+	free(q->bucket);
+	free(q->bucket_tail);
+	pool_free(&q->nodes);
+	memset(q, 0, sizeof(struct fel));
+}
+
+/* returns 0 on success, -1 if out of memory */
+int fel_insert(struct fel *q, long int time, void *data)
+{
+	switch (q->kind) {
+	case FEL_HEAP:
+		return heap_insert(q, time, data);
+	case FEL_CALENDAR:
+		return cq_insert(q, time, data);
+	case FEL_WHEEL:
+		return wheel_insert(q, time, data);
+	default:
+		return -1;
+	}
+}
+
+/* time of the earliest event, LONG_MAX if there is none */
+long int fel_min(struct fel *q)
+{
+	if (!(q->size)) return LONG_MAX;
+	switch (q->kind) {
+	case FEL_HEAP:
+		return q->heap[0].time;
+	case FEL_CALENDAR:
+		return q->bucket[cq_locate(q)]->time;
+	case FEL_WHEEL:
+		return wheel_min(q);
+	default:
+		return LONG_MAX;
+	}
+}
+
+/* remove the earliest event into e, returns 0 if there is none */
+int fel_pop(struct fel *q, struct event *e)
+{
+	if (!(q->size)) return 0;
+	switch (q->kind) {
+	case FEL_HEAP:
+		return heap_pop(q, e);
+	case FEL_CALENDAR:
+		return cq_pop(q, e);
+	case FEL_WHEEL:
+		return wheel_pop(q, e);
+	default:
+		return 0;
+	}
+}
+
+/* binary heap */
+
+static int heap_insert(struct fel *q, long int time, void *data)
+{
+	struct event *h;
+	long int i, parent;
+
+	if (q->size == q->heap_max) {
+		if ( !(h = realloc(q->heap, 2*q->heap_max*sizeof(struct event))) ) return -1;
+		q->heap = h;
+		q->heap_max *= 2;
+	}
+	h = q->heap;
+
+	/* sift up */
+	i = q->size++;
+	while (i) {
+		parent = (i - 1)/2;
+		if (h[parent].time <= time) break;
+		h[i] = h[parent];
+		i = parent;
+	}
+	h[i].time = time;
+	h[i].data = data;
+	return 0;
+}
+
+static int heap_pop(struct fel *q, struct event *e)
+{
+	struct event *h = q->heap;
+	struct event last;
+	long int i, child;
+
+	*e = h[0];
+	last = h[--q->size];
+
+	/* sift down */
+	i = 0;
+	while ( (child = 2*i + 1) < q->size ) {
+		if ( (child + 1 < q->size)&&(h[child+1].time < h[child].time) ) ++child;
+		if (last.time <= h[child].time) break;
+		h[i] = h[child];
+		i = child;
+	}
+	h[i] = last;
+	return 1;
+}
+
+/* calendar queue: buckets of sorted lists, each bucket holding the
+ * events of a width ticks long day of a nbuckets days long year */
+
+static int cmp_node_time(const void *a, const void *b)
+{
+	long int ta = (*(struct fel_node **)a)->time;
+	long int tb = (*(struct fel_node **)b)->time;
+
+	return (ta > tb) - (ta < tb);
+}
+
+/* rebuild the calendar with nb buckets, sizing them from the
+ * separation of the earliest events */
+static int cq_resize(struct fel *q, long int nb)
+{
+	struct fel_node **all = NULL;
+	struct fel_node **bucket, **tail;
+	struct fel_node *n;
+	long int i, k, b, gap, sum, count;
+
+	if ( !(bucket = calloc(nb, sizeof(struct fel_node *))) ) return -1;
+	if ( !(tail = calloc(nb, sizeof(struct fel_node *))) ) {
+		free(bucket);
+		return -1;
+	}
+
+	if (q->size) {
+		if ( !(all = malloc(q->size*sizeof(struct fel_node *))) ) {
+			free(bucket);
+			free(tail);
+			return -1;
+		}
+		k = 0;
+		for (i=0;i<q->nbuckets;++i)
+			for (n=q->bucket[i];n;n=n->next) all[k++] = n;
+		qsort(all, q->size, sizeof(struct fel_node *), cmp_node_time);
+
+		/* width is 3 times the mean separation, leaving out
+		 * separations more than twice the average */
+		count = (q->size < CQ_SAMPLE) ? q->size : CQ_SAMPLE;
+		if (count > 1) {
+			gap = (all[count-1]->time - all[0]->time)/(count - 1);
+			sum = 0;
+			k = 0;
+			for (i=1;i<count;++i)
+				if (all[i]->time - all[i-1]->time <= 2*gap) {
+					sum += all[i]->time - all[i-1]->time;
+					++k;
+				}
+			q->width = (k && sum) ? 3*sum/k : 1;
+			if (q->width < 1) q->width = 1;
+		}
+	}
+
+	free(q->bucket);
+	free(q->bucket_tail);
+	q->bucket = bucket;
+	q->bucket_tail = tail;
+	q->nbuckets = nb;
+
+	/* events come sorted, so each one goes to the tail of its bucket */
+	for (i=0;i<q->size;++i) {
+		n = all[i];
+		b = (n->time/q->width) & (nb - 1);
+		n->next = NULL;
+		if (tail[b]) tail[b]->next = n;
+		else bucket[b] = n;
+		tail[b] = n;
+	}
+
+	q->last_time = q->size ? all[0]->time : 0;
+	q->last_bucket = (q->last_time/q->width) & (nb - 1);
+	q->bucket_top = (q->last_time/q->width + 1)*q->width;
+	free(all);
+	return 0;
+}
+
+static int cq_insert(struct fel *q, long int time, void *data)
+{
+	struct fel_node *n, *p;
+	long int b;
+
+	if ( !(n = pool_get(&q->nodes)) ) return -1;
+	n->time = time;
+	n->data = data;
+	n->next = NULL;
+
+	if (time < q->last_time) {
+		q->last_time = time;
+		q->last_bucket = (time/q->width) & (q->nbuckets - 1);
+		q->bucket_top = (time/q->width + 1)*q->width;
+	}
+
+	/* keep the bucket sorted by time */
+	b = (time/q->width) & (q->nbuckets - 1);
+	if ( !(q->bucket_tail[b]) || (q->bucket_tail[b]->time <= time) ) {
+		if (q->bucket_tail[b]) q->bucket_tail[b]->next = n;
+		else q->bucket[b] = n;
+		q->bucket_tail[b] = n;
+	} else if (q->bucket[b]->time > time) {
+		n->next = q->bucket[b];
+		q->bucket[b] = n;
+	} else {
+		p = q->bucket[b];
+		while (p->next->time <= time) p = p->next;
+		n->next = p->next;
+		p->next = n;
+	}
+
+	/* a failed resize leaves the calendar as it was */
+	if (++q->size > 2*q->nbuckets) cq_resize(q, 2*q->nbuckets);
+	return 0;
+}
+
+/* bucket holding the earliest event; the queue must not be empty */
+static long int cq_locate(struct fel *q)
+{
+	long int i, n, top, best;
+
+	/* walk the days of the current year */
+	i = q->last_bucket;
+	top = q->bucket_top;
+	for (n=0;n<q->nbuckets;++n) {
+		if ( (q->bucket[i])&&(q->bucket[i]->time < top) ) {
+			q->last_bucket = i;
+			q->bucket_top = top;
+			q->last_time = q->bucket[i]->time;
+			return i;
+		}
+		i = (i + 1) & (q->nbuckets - 1);
+		top += q->width;
+	}
+
+	/* nothing this year, search directly for the earliest event */
+	best = -1;
+	for (i=0;i<q->nbuckets;++i)
+		if ( (q->bucket[i])&&((best < 0)||(q->bucket[i]->time < q->bucket[best]->time)) )
+			best = i;
+	q->last_bucket = best;
+	q->last_time = q->bucket[best]->time;
+	q->bucket_top = (q->last_time/q->width + 1)*q->width;
+	return best;
+}
+
+static int cq_pop(struct fel *q, struct event *e)
+{
+	struct fel_node *n;
+	long int b;
+
+	b = cq_locate(q);
+	n = q->bucket[b];
+	if ( !(q->bucket[b] = n->next) ) q->bucket_tail[b] = NULL;
+	e->time = n->time;
+	e->data = n->data;
+	pool_put(&q->nodes, n);
+
+	if ( (--q->size < q->nbuckets/2 - 2)&&(q->nbuckets > 2) )
+		cq_resize(q, q->nbuckets/2);
+	return 1;
+}
+
+/* hierarchical timing wheel: an event goes to the level of the highest
+ * byte its time differs in from wheel_time, and to the slot of that
+ * byte of its time; emptying the lower levels cascades the earliest
+ * non-empty slot of the next level down */
+
+static int wheel_insert(struct fel *q, long int time, void *data)
+{
+	struct fel_node *n;
+
+	if ( !(n = pool_get(&q->nodes)) ) return -1;
+	n->time = time;
+	n->data = data;
+	wheel_place(q, n);
+	++q->size;
+	return 0;
+}
+
+static void wheel_place(struct fel *q, struct fel_node *n)
+{
+	unsigned long int x;
+	long int t;
+	int level, s;
+
+	/* events may not be scheduled before the last one popped */
+	t = (n->time < q->wheel_time) ? q->wheel_time : n->time;
+	level = 0;
+	for (x=(unsigned long int)(t ^ q->wheel_time);x>>8;x>>=8) ++level;
+	s = (t >> (8*level)) & (WHEEL_SLOTS - 1);
+	n->next = q->slot[level][s];
+	q->slot[level][s] = n;
+	q->used[level][s/64] |= 1UL << (s%64);
+}
+
+/* first non-empty slot of a level from slot s on, -1 if none */
+static int next_used(struct fel *q, int level, int s)
+{
+	unsigned long int w;
+	int i;
+
+	for (i=s/64;i<WHEEL_SLOTS/64;++i) {
+		w = q->used[level][i];
+		if (i == s/64) w &= ~0UL << (s%64);
+		if (w) return 64*i + __builtin_ctzl(w);
+	}
+	return -1;
+}
+
+static long int wheel_min(struct fel *q)
+{
+	struct fel_node *n;
+	long int min;
+	int level, s;
+
+	if ( (s = next_used(q, 0, q->wheel_time & (WHEEL_SLOTS - 1))) >= 0 )
+		return q->slot[0][s]->time;
+
+	/* earliest event of the first non-empty slot upwards */
+	for (level=1;level<WHEEL_LEVELS;++level) {
+		s = (q->wheel_time >> (8*level)) & (WHEEL_SLOTS - 1);
+		if ( (s = next_used(q, level, s + 1)) >= 0 ) break;
+	}
+	min = LONG_MAX;
+	for (n=q->slot[level][s];n;n=n->next)
+		if (n->time < min) min = n->time;
+	return min;
+}
+
+static int wheel_pop(struct fel *q, struct event *e)
+{
+	struct fel_node *n, *list;
+	unsigned long int mask;
+	int level, s;
+
+	while ( (s = next_used(q, 0, q->wheel_time & (WHEEL_SLOTS - 1))) < 0 ) {
+		for (level=1;level<WHEEL_LEVELS;++level) {
+			s = (q->wheel_time >> (8*level)) & (WHEEL_SLOTS - 1);
+			if ( (s = next_used(q, level, s + 1)) >= 0 ) break;
+		}
+
+		/* move to the start of that slot and spread it below */
+		mask = (8*(level + 1) < (int)(8*sizeof(long int))) ? (~0UL << (8*(level + 1))) : 0;
+		q->wheel_time = (q->wheel_time & mask) | ((long int)s << (8*level));
+		list = q->slot[level][s];
+		q->slot[level][s] = NULL;
+		q->used[level][s/64] &= ~(1UL << (s%64));
+		while ((n = list)) {
+			list = n->next;
+			wheel_place(q, n);
+		}
+	}
+
+	n = q->slot[0][s];
+	if ( !(q->slot[0][s] = n->next) ) q->used[0][s/64] &= ~(1UL << (s%64));
+	q->wheel_time = (q->wheel_time & ~(long int)(WHEEL_SLOTS - 1)) | s;
+	e->time = n->time;
+	e->data = n->data;
+	pool_put(&q->nodes, n);
+	--q->size;
+	return 1;
+}
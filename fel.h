@@ -0,0 +1,63 @@
+/* future event list: pending events ordered by the tick they happen at */
+
+#ifndef FEL_H
+#define FEL_H
+
+#include "pool.h"
+
+/* future event list backends: */
+#define FEL_HEAP 1
+#define FEL_CALENDAR 2
+#define FEL_WHEEL 3
+
+struct event {
+	long int time;
+	void *data;
+};
+
+/* linked event, used by the calendar queue and the timing wheel */
+struct fel_node {
+	long int time;
+	void *data;
+	struct fel_node *next;
+};
+
+/* timing wheel: 8 levels of 256 slots cover every long int tick */
+#define WHEEL_LEVELS 8
+#define WHEEL_SLOTS 256
+
+struct fel {
+	int kind;
+	long int size; /* number of pending events */
+
+	/* binary heap */
+	struct event *heap;
+	long int heap_max;
+
+	/* calendar queue */
+	struct fel_node **bucket;
+	struct fel_node **bucket_tail;
+	long int nbuckets; /* always a power of 2 */
+	long int width; /* ticks covered by one bucket */
+	long int last_bucket; /* bucket of the last event dequeued */
+	long int bucket_top; /* end of the current year in last_bucket */
+	long int last_time; /* time of the last event dequeued */
+
+	/* timing wheel */
+	struct fel_node *slot[WHEEL_LEVELS][WHEEL_SLOTS];
+	unsigned long int used[WHEEL_LEVELS][WHEEL_SLOTS/64]; /* non-empty slots */
+	long int wheel_time; /* no pending event is earlier than this */
+
+	/* nodes of the calendar queue and the timing wheel */
+	struct pool nodes;
+};
+
+int fel_kind(const char *name);
+const char *fel_name(int kind);
+int fel_init(struct fel *q, int kind);
+void fel_free(struct fel *q);
+int fel_insert(struct fel *q, long int time, void *data);
+long int fel_min(struct fel *q);
+int fel_pop(struct fel *q, struct event *e);
+
+#endif
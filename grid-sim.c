@@ -0,0 +1,153 @@
+/* simulation of Grid scheduling algorithms:
+ * First-Come, First-Serve (FCFS), Least Work First (LWF),
+ * mixed (LWF+FCFS) and scheduling with Advance Reservations (AR);
+ * the command line of the simulation library (see sim.h), running the
+ * policies one after the other in the background */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <unistd.h>
+#include <limits.h>
+#include "fel.h"
+#include "jobq.h"
+#include "kernel.h"
+#include "rng.h"
+#include "sim.h"
+#include "stats.h"
+
+/* function declaration */
+void usage();
+int output_path();
+void request_report();
+void request_stop();
+
+/* global variables */
+struct simulation *running = NULL; /* the simulation main() runs, for the signal handlers */
+volatile sig_atomic_t stopped = 0; /* SIGINT or SIGTERM came */
+
+int main(int argc, char *argv[])
+{
+	struct sim_config config;
+	struct simulation *sim;
+	char *output = NULL;
+	int format = STATS_TEXT;
+	int output_flags = 0;
+	int foreground = 0;
+	char path[PATH_MAX];
+	int c, i, err;
+
+	/* select future event list and job queue backends, job kernel, output and policies */
+	sim_defaults(&config);
+	while ( (c = getopt(argc,argv,"e:q:r:k:o:af:c:p:F")) != -1 )
+		switch (c) {
+		case 'e':
+			if (!(config.fel = fel_kind(optarg))) usage(argv[0]);
+			break;
+		case 'q':
+			if (!(config.jobq = jobq_kind(optarg))) usage(argv[0]);
+			break;
+		case 'r':
+			if (!(config.rng = rng_kind(optarg))) usage(argv[0]);
+			break;
+		case 'k':
+			if ( !(config.kernel = kernel_kind(optarg))||!kernel_supported(config.kernel) ) usage(argv[0]);
+			break;
+		case 'o':
+			output = optarg;
+			break;
+		case 'a':
+			output_flags |= SINK_ATOMIC;
+			break;
+		case 'f':
+			if (!(format = stats_format(optarg))) usage(argv[0]);
+			break;
+		case 'c':
+			if (sim_read_config(&config,optarg)) exit(EINVAL);
+			break;
+		case 'p':
+			if (sim_set(&config,optarg,"-p")) exit(EINVAL);
+			break;
+		case 'F':
+			foreground = 1;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	if (optind == argc) usage(argv[0]);
+	if (sim_check(&config)) exit(EINVAL);
+	if (!output) output = (format == STATS_BINARY) ? "%s-sim.out.bin" : "%s-sim.out.txt";
+	for (i=optind;i<argc;++i)
+		if ( !(sim_policy(argv[i]))||output_path(path,output,argv[i]) ) usage(argv[0]);
+
+	/* go to background, unless run by a driver waiting for it */
+	if ( !foreground&&fork() ) exit(0);
+
+	/* on SIGUSR1, report the jobs and resources in each state */
+	if ( signal(SIGUSR1, request_report)==SIG_ERR )
+		exit(errno);
+
+	/* on SIGINT or SIGTERM, stop and write out what is recorded */
+	if ( (signal(SIGINT, request_stop)==SIG_ERR)||(signal(SIGTERM, request_stop)==SIG_ERR) )
+		exit(errno);
+
+	/* run the policies one after the other, on the same workload */
+	for (i=optind;(i<argc)&&!stopped;++i) {
+		config.policy = sim_policy(argv[i]);
+		output_path(path,output,argv[i]);
+		if ( !(sim = sim_create(&config)) ) exit(errno);
+		if (sim_output(sim,path,format,output_flags)) {
+			err = errno;
+			perror(path);
+			exit(err);
+		}
+		running = sim;
+		if (stopped) sim_stop(sim);
+		if ( (err = (sim_run(sim) < 0) ? errno : 0) ) perror(argv[i]);
+		running = NULL;
+		if (sim_destroy(sim)) {
+			if (!err) err = errno;
+			perror(path);
+			exit(err);
+		}
+		if (err) exit(err);
+	}
+	exit(0);
+}
+
+void usage(char *name)
+{
+	fprintf(stderr,"usage: %s [-e heap|calendar|wheel] [-q heap|pairing|bucket] [-r xoshiro|legacy] [-k scalar|sse2|avx2]\n"
+	    "\t[-f text|binary] [-o output] [-a]\n"
+	    "\t[-c config] [-p parameter=value] [-F] fcfs|lwf|mixed|ar ...\n",name);
+	exit(EINVAL);
+}
+
+/* output file of a policy: the output option with %s, if there is
+ * one, replaced by the policy name; returns -1 if it does not fit
+ * in PATH_MAX or has another % */
+int output_path(char *path, char *output, char *name)
+{
+	char *s = strstr(output,"%s");
+
+	if ( (strchr(output,'%') != s)||(s&&strchr(s + 1,'%')) ) return -1;
+	if (!s) s = output + strlen(output);
+	if ( strlen(output) + strlen(name) >= PATH_MAX ) return -1;
+	sprintf(path,"%.*s%s%s",(int)(s - output),output,(*s ? name : ""),(*s ? s + 2 : ""));
+	return 0;
+}
+
+void request_report()
+{
+	if (running) sim_request_report(running);
+	if ( signal(SIGUSR1, request_report)==SIG_ERR )
+		exit(errno);
+}
+
+void request_stop()
+{
+	stopped = 1;
+	if (running) sim_stop(running);
+}
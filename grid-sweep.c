@@ -0,0 +1,376 @@
+/* parameter sweep: runs the simulation library over the points of a
+ * grid of parameters, each policy at each point a simulation of its own,
+ * on a pool of worker threads, one per processor, in this process.
+ * Each worker takes simulations from its own deque and, when that runs
+ * dry, steals from the other end of another's, so that long points
+ * (near saturation) do not leave the other workers idle at the end.
+ *
+ * Point n writes its result set to directory/n: the configuration of
+ * the point, every parameter and backend as a grid-sim config file,
+ * and the statistics of each policy, replacing those of an earlier
+ * sweep into the same directory. Points and policies of an earlier
+ * sweep that are not in this one keep their outputs: clear the
+ * directory first if the grid has changed. directory/points lists the
+ * points, a line each.
+ *
+ * usage: grid-sweep [-j workers] [-d directory] [-c config] [-e fel]
+ *	[-q jobq] [-r rng] [-f format] -g parameter=values ... policy ...
+ * where values are v1,v2,... or from:to:step */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "fel.h"
+#include "jobq.h"
+#include "rng.h"
+#include "sim.h"
+#include "stats.h"
+
+/* parameters and values a dimension of the grid can have */
+#define DIMENSIONS 16
+#define VALUES 1024
+
+/* a parameter swept over */
+struct dimension {
+	char *name;
+	long int value[VALUES];
+	int n;
+};
+
+/* simulations of a worker, taken from the bottom by the worker and
+ * stolen from the top by the others */
+struct deque {
+	pthread_mutex_t lock;
+	long int *task;
+	long int top;
+	long int bottom;
+};
+
+/* function declaration */
+void usage();
+int add_dimension();
+long int point_value();
+int point_config();
+int write_points();
+void *work();
+long int take();
+long int steal();
+int simulate();
+double seconds();
+
+struct dimension grid[DIMENSIONS];
+int dimensions;
+char **policies;
+int npolicies;
+long int points = 1;
+char *directory = "sweep";
+struct sim_config config; /* of every point, before its settings */
+int format = STATS_TEXT;
+char *suffix = "txt";
+
+struct deque *deques;
+int workers;
+pthread_mutex_t output_lock = PTHREAD_MUTEX_INITIALIZER;
+long int failed;
+
+int main(int argc, char *argv[])
+{
+	pthread_t *threads;
+	long int t, tasks;
+	double start, elapsed;
+	int c, i;
+
+	workers = sysconf(_SC_NPROCESSORS_ONLN);
+	sim_defaults(&config);
+	while ( (c = getopt(argc,argv,"j:d:c:e:q:r:f:g:")) != -1 )
+		switch (c) {
+		case 'j':
+			if ( (workers = atoi(optarg)) < 1 ) usage(argv[0]);
+			break;
+		case 'd':
+			directory = optarg;
+			break;
+		case 'c':
+			if (sim_read_config(&config,optarg)) exit(EINVAL);
+			break;
+		case 'e':
+			if (!(config.fel = fel_kind(optarg))) usage(argv[0]);
+			break;
+		case 'q':
+			if (!(config.jobq = jobq_kind(optarg))) usage(argv[0]);
+			break;
+		case 'r':
+			if (!(config.rng = rng_kind(optarg))) usage(argv[0]);
+			break;
+		case 'f':
+			if (!(format = stats_format(optarg))) usage(argv[0]);
+			if (format == STATS_BINARY) suffix = "bin";
+			break;
+		case 'g':
+			if (add_dimension(optarg)) exit(EINVAL);
+			break;
+		default:
+			usage(argv[0]);
+		}
+	if (optind == argc) usage(argv[0]);
+	policies = argv + optind;
+	npolicies = argc - optind;
+	for (i=0;i<npolicies;++i)
+		if (!sim_policy(policies[i])) usage(argv[0]);
+	if (workers < 1) workers = 1;
+	if (write_points()) exit(errno);
+
+	/* deal the simulations out to the workers in runs of consecutive ones */
+	tasks = points*npolicies;
+	if (workers > tasks) workers = tasks;
+	deques = calloc(workers,sizeof(struct deque));
+	threads = calloc(workers,sizeof(pthread_t));
+	if ( !deques||!threads ) exit(ENOMEM);
+	for (i=0;i<workers;++i) {
+		pthread_mutex_init(&deques[i].lock,NULL);
+		deques[i].top = tasks*i/workers;
+		deques[i].bottom = tasks*(i + 1)/workers;
+		if ( !(deques[i].task = malloc((deques[i].bottom - deques[i].top + 1)*sizeof(long int))) )
+			exit(ENOMEM);
+		for (t=deques[i].top;t<deques[i].bottom;++t)
+			deques[i].task[t - deques[i].top] = t;
+		deques[i].bottom -= deques[i].top;
+		deques[i].top = 0;
+	}
+
+	start = seconds();
+	for (i=0;i<workers;++i)
+		if ( (errno = pthread_create(&threads[i],NULL,work,(void *)(long int)i)) ) exit(errno);
+	for (i=0;i<workers;++i)
+		pthread_join(threads[i],NULL);
+	elapsed = seconds() - start;
+
+	printf("%li simulations (%li points, %i policies) in %.1fs on %i workers: %.0f simulations/hour",
+	    tasks,points,npolicies,elapsed,workers,(elapsed > 0) ? tasks*3600/elapsed : 0);
+	if (failed) printf(", %li failed",failed);
+	printf("\n");
+	return failed ? 1 : 0;
+}
+
+void usage(char *name)
+{
+	fprintf(stderr,"usage: %s [-j workers] [-d directory] [-c config] [-e fel] [-q jobq]\n"
+	    "\t[-r xoshiro|legacy] [-f format] -g parameter=values ... fcfs|lwf|mixed|ar ...\n"
+	    "values: v1,v2,... or from:to:step\n",name);
+	exit(EINVAL);
+}
+
+/* add a dimension "name=v1,v2,..." or "name=from:to:step" to the grid;
+ * returns -1 if it is not valid */
+int add_dimension(char *setting)
+{
+	struct dimension *d;
+	char *value, *end;
+	long int from, to, step, v;
+
+	if ( (dimensions == DIMENSIONS)||!(value = strchr(setting,'='))||(value == setting) ) {
+		fprintf(stderr,"-g %s: not a parameter=values dimension, or too many\n",setting);
+		return -1;
+	}
+	d = &grid[dimensions];
+	d->name = setting;
+	*value++ = 0;
+	d->n = 0;
+	errno = 0;
+	from = strtol(value,&end,10);
+	if ( (end != value)&&(*end == ':') ) {
+		to = strtol(value = end + 1,&end,10);
+		if ( (end == value)||(*end != ':') ) goto invalid;
+		step = strtol(value = end + 1,&end,10);
+		if ( (end == value)||*end||errno||(step < 1)||(to < from)||((to - from)/step >= VALUES) ) goto invalid;
+		for (v=from;v<=to;v+=step)
+			d->value[d->n++] = v;
+	} else {
+		for (end=value;*end;) {
+			v = strtol(value = end,&end,10);
+			if ( (end == value)||errno||(d->n == VALUES) ) goto invalid;
+			d->value[d->n++] = v;
+			if (*end == ',') {
+				if (!*++end) goto invalid;
+			} else if (*end) goto invalid;
+		}
+		if (!(d->n)) goto invalid;
+	}
+	if (points > LONG_MAX/d->n) goto invalid;
+	points *= d->n;
+	++dimensions;
+	return 0;
+
+invalid:
+	fprintf(stderr,"-g %s: values must be v1,v2,... or from:to:step, up to %i of them\n",setting,VALUES);
+	return -1;
+}
+
+/* the value of dimension i at a point, the last dimension varying fastest */
+long int point_value(long int point, int i)
+{
+	for (++i;i<dimensions;++i)
+		point /= grid[i].n;
+	return point;
+}
+
+/* the configuration of a point: the one of the options with the
+ * settings of the point; returns -1 if they are not valid */
+int point_config(long int n, struct sim_config *c)
+{
+	char setting[256], where[64];
+	int i;
+
+	*c = config;
+	snprintf(where,sizeof(where),"point %li",n);
+	for (i=0;i<dimensions;++i) {
+		snprintf(setting,sizeof(setting),"%s=%li",grid[i].name,grid[i].value[point_value(n,i) % grid[i].n]);
+		if (sim_set(c,setting,where)) return -1;
+	}
+	return sim_check(c);
+}
+
+/* create the directory of each point, holding its whole configuration,
+ * and the list of points; returns 0 on success, -1 with errno set on
+ * failure */
+int write_points()
+{
+	char path[PATH_MAX];
+	struct sim_config c;
+	FILE *list, *fp;
+	long int n, k;
+	int i, err;
+
+	for (n=0;n<points;++n)
+		if (point_config(n,&c)) {
+			errno = EINVAL;
+			return -1;
+		}
+	if ( mkdir(directory,0755)&&(errno != EEXIST) ) {
+		perror(directory);
+		return -1;
+	}
+	snprintf(path,sizeof(path),"%s/points",directory);
+	if ( !(list = fopen(path,"w")) ) {
+		perror(path);
+		return -1;
+	}
+	for (n=0;n<points;++n) {
+		snprintf(path,sizeof(path),"%s/%li",directory,n);
+		if ( mkdir(path,0755)&&(errno != EEXIST) ) {
+			perror(path);
+			fclose(list);
+			return -1;
+		}
+		snprintf(path,sizeof(path),"%s/%li/config",directory,n);
+		if ( !(fp = fopen(path,"w")) ) {
+			perror(path);
+			fclose(list);
+			return -1;
+		}
+		point_config(n,&c);
+		fprintf(fp,"# statistics written as %s\n",(format == STATS_BINARY) ? "binary" : "text");
+		fprintf(list,"%li",n);
+		for (i=0;i<dimensions;++i) {
+			k = point_value(n,i) % grid[i].n;
+			fprintf(list," %s=%li",grid[i].name,grid[i].value[k]);
+		}
+		fprintf(list,"\n");
+		err = sim_write_config(&c,fp);
+		if ( fclose(fp)||err ) {
+			perror(path);
+			fclose(list);
+			return -1;
+		}
+	}
+	return fclose(list);
+}
+
+/* a worker runs the simulations of its deque, then those it can steal */
+void *work(void *arg)
+{
+	int self = (long int)arg;
+	long int t;
+
+	while ( ((t = take(self)) >= 0)||((t = steal(self)) >= 0) )
+		simulate(t);
+	return NULL;
+}
+
+/* the bottom simulation of a worker's own deque, or -1 if it is empty */
+long int take(int self)
+{
+	struct deque *q = &deques[self];
+	long int t = -1;
+
+	pthread_mutex_lock(&q->lock);
+	if (q->top < q->bottom) t = q->task[--q->bottom];
+	pthread_mutex_unlock(&q->lock);
+	return t;
+}
+
+/* the top simulation of the first other worker's deque that has one, or
+ * -1 if all are empty; simulations are never added, so they stay empty */
+long int steal(int self)
+{
+	struct deque *q;
+	long int t = -1;
+	int i;
+
+	for (i=1;(i<workers)&&(t < 0);++i) {
+		q = &deques[(self + i) % workers];
+		pthread_mutex_lock(&q->lock);
+		if (q->top < q->bottom) t = q->task[q->top++];
+		pthread_mutex_unlock(&q->lock);
+	}
+	return t;
+}
+
+/* run simulation t, policy t % npolicies at point t / npolicies;
+ * returns 0, or the errno of its failure */
+int simulate(long int t)
+{
+	char output[PATH_MAX];
+	struct sim_config c;
+	struct simulation *sim;
+	long int n = t/npolicies;
+	char *policy = policies[t % npolicies];
+	double start;
+	int err = 0;
+
+	snprintf(output,sizeof(output),"%s/%li/%s-sim.out.%s",directory,n,policy,suffix);
+	start = seconds();
+	point_config(n,&c);
+	c.policy = sim_policy(policy);
+	if ( !(sim = sim_create(&c)) ) err = errno;
+	else {
+		if ( sim_output(sim,output,format,SINK_TRUNCATE)||(sim_run(sim) < 0) ) err = errno;
+		if ( sim_destroy(sim)&&!err ) err = errno;
+	}
+
+	pthread_mutex_lock(&output_lock);
+	printf("point %li %s: %.1fs",n,policy,seconds() - start);
+	if (err) {
+		printf(", failed (%s)",strerror(err));
+		++failed;
+	}
+	printf("\n");
+	fflush(stdout);
+	pthread_mutex_unlock(&output_lock);
+	return err;
+}
+
+double seconds()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+}
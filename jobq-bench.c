@@ -0,0 +1,83 @@
+/* job queue benchmark: hold model (schedule the first waiting job,
+ * a new job arrives) over the backends in jobq.c, keyed on the
+ * workloads of the simulators (50..999), with deep queues
+ *
+ * usage: jobq-bench [waiting jobs ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "jobq.h"
+
+/* hold operations timed for each size */
+#define HOLDS 2000000
+
+/* function declaration */
+long int workload();
+double hold();
+
+unsigned long int seed = 1;
+
+/* codes of the jobs taken, summed with their order, must agree
+ * between the backends */
+unsigned long int taken;
+
+int main(int argc, char *argv[])
+{
+	static long int sizes[] = { 1000, 100000, 10000000 };
+	int kinds[] = { JOBQ_HEAP, JOBQ_PAIRING, JOBQ_BUCKET };
+	unsigned long int first;
+	long int n;
+	int i, k, count;
+
+	count = (argc > 1) ? argc - 1 : 3;
+	printf("%10s %10s %10s %10s\n", "waiting", "heap", "pairing", "bucket");
+	for (i=0;i<count;++i) {
+		n = (argc > 1) ? atol(argv[i+1]) : sizes[i];
+		printf("%10li", n);
+		for (k=0;k<3;++k) {
+			printf(" %8.1fns", hold(kinds[k], n));
+			fflush(stdout);
+			if (!k) first = taken;
+			else if (taken != first) {
+				fprintf(stderr, "\n%s: jobs taken in another order than by %s\n",
+				    jobq_name(kinds[k]), jobq_name(kinds[0]));
+				exit(1);
+			}
+		}
+		printf("\n");
+	}
+	return 0;
+}
+
+/* workload of a new job, as the simulators draw it */
+long int workload()
+{
+	seed = seed*6364136223846793005UL + 1442695040888963407UL;
+	return 50 + (seed >> 33) % 950;
+}
+
+/* nanoseconds per hold operation with n waiting jobs */
+double hold(int kind, long int n)
+{
+	struct jobq q;
+	struct timespec t0, t1;
+	long int i, code, job;
+
+	if (jobq_init(&q, kind, 50, 999)) return 0;
+	seed = 1;
+	for (code=1;code<=n;++code) jobq_insert(&q, workload(), code, code);
+
+	taken = 0;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i=0;i<HOLDS;++i) {
+		job = jobq_pop(&q);
+		taken = taken*31 + job;
+		jobq_insert(&q, workload(), code, code);
+		++code;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	jobq_free(&q);
+	return ((t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec))/HOLDS;
+}
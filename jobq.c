@@ -0,0 +1,322 @@
+/* job priority queue backends:
+ * binary heap, pairing heap (Fredman, Sedgewick, Sleator and Tarjan, 1986)
+ * and bucket queue over a bounded key range */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "jobq.h"
+
+/* nodes of the first table, doubled when they are all in use */
+#define NODE_SLAB 4096
+
+/* function declaration */
+static long int new_node(struct jobq *q);
+static int precedes(struct jobq *q, long int a, long int b);
+static int binary_insert(struct jobq *q, long int n);
+static long int binary_pop(struct jobq *q);
+static long int meld(struct jobq *q, long int a, long int b);
+static long int pairing_pop(struct jobq *q);
+static void bucket_insert(struct jobq *q, long int n);
+static long int bucket_first(struct jobq *q);
+static long int bucket_pop(struct jobq *q);
+
+int jobq_kind(const char *name)
+{
+	if (!strcmp(name,"heap")) return JOBQ_HEAP;
+	if (!strcmp(name,"pairing")) return JOBQ_PAIRING;
+	if (!strcmp(name,"bucket")) return JOBQ_BUCKET;
+	return 0;
+}
+
+const char *jobq_name(int kind)
+{
+	switch (kind) {
+	case JOBQ_HEAP:
+		return "heap";
+	case JOBQ_PAIRING:
+		return "pairing";
+	case JOBQ_BUCKET:
+		return "bucket";
+	default:
+		return NULL;
+	}
+}
+
+/* keys are in key_min..key_max, the bucket queue needs the bound;
+ * returns 0 on success, -1 if kind is unknown or out of memory */
+int jobq_init(struct jobq *q, int kind, long int key_min, long int key_max)
+{
+	memset(q, 0, sizeof(struct jobq));
+	q->kind = kind;
+	q->free_node = -1;
+	q->root = -1;
+	switch (kind) {
+	case JOBQ_HEAP:
+		q->heap_max = 1024;
+		if ( !(q->heap = malloc(q->heap_max*sizeof(int32_t))) ) return -1;
+		return 0;
+	case JOBQ_PAIRING:
+		return 0;
+	case JOBQ_BUCKET:
+		q->key_min = key_min;
+		q->nbuckets = key_max - key_min + 1;
+		if ( !(q->bucket = malloc(q->nbuckets*sizeof(int32_t)))
+		    ||!(q->bucket_tail = malloc(q->nbuckets*sizeof(int32_t)))
+		    ||!(q->used = calloc((q->nbuckets + 63)/64, sizeof(unsigned long int))) ) return -1;
+		memset(q->bucket, 0xff, q->nbuckets*sizeof(int32_t));
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+void jobq_free(struct jobq *q)
+{
+	free(q->node);
+	free(q->heap);
+	free(q->bucket);
+	free(q->bucket_tail);
+	free(q->used);
+	memset(q, 0, sizeof(struct jobq));
+}
+
+/* a node off the free list, the table doubled if there is none;
+ * returns -1 if out of memory */
+static long int new_node(struct jobq *q)
+{
+	struct jobq_node *p;
+	long int i, max;
+
+	if (q->free_node < 0) {
+		max = q->node_max ? 2*q->node_max : NODE_SLAB;
+		if ( (max > INT32_MAX)||!(p = realloc(q->node, max*sizeof(struct jobq_node))) ) return -1;
+		for (i=q->node_max;i<max;++i)
+			p[i].next = (i + 1 < max) ? i + 1 : -1;
+		q->node = p;
+		q->free_node = q->node_max;
+		q->node_max = max;
+	}
+	i = q->free_node;
+	q->free_node = q->node[i].next;
+	return i;
+}
+
+/* queue a job, returns its node (the caller passes it to jobq_moved()
+ * if the job moves in its table), -1 if out of memory */
+long int jobq_insert(struct jobq *q, long int key, long int code, long int job)
+{
+	struct jobq_node *n;
+	long int i, root = q->root;
+
+	if ( (i = new_node(q)) < 0 ) return -1;
+	n = &q->node[i];
+	n->key = key;
+	n->code = code;
+	n->job = job;
+	n->child = -1;
+	n->next = -1;
+	switch (q->kind) {
+	case JOBQ_HEAP:
+		if (binary_insert(q, i)) {
+			n->next = q->free_node;
+			q->free_node = i;
+			return -1;
+		}
+		break;
+	case JOBQ_PAIRING:
+		q->root = meld(q, root, i);
+		break;
+	case JOBQ_BUCKET:
+		bucket_insert(q, i);
+		break;
+	}
+	++q->size;
+	return i;
+}
+
+/* the job of a node moved to index job in its table */
+void jobq_moved(struct jobq *q, long int node, long int job)
+{
+	q->node[node].job = job;
+}
+
+/* job of the first entry, -1 if there is none */
+long int jobq_min(struct jobq *q)
+{
+	if (!(q->size)) return -1;
+	switch (q->kind) {
+	case JOBQ_HEAP:
+		return q->node[q->heap[0]].job;
+	case JOBQ_PAIRING:
+		return q->node[q->root].job;
+	case JOBQ_BUCKET:
+		return q->node[q->bucket[bucket_first(q)]].job;
+	default:
+		return -1;
+	}
+}
+
+/* remove the first entry, returns its job, -1 if there is none */
+long int jobq_pop(struct jobq *q)
+{
+	long int i;
+
+	if (!(q->size)) return -1;
+	switch (q->kind) {
+	case JOBQ_HEAP:
+		i = binary_pop(q);
+		break;
+	case JOBQ_PAIRING:
+		i = pairing_pop(q);
+		break;
+	case JOBQ_BUCKET:
+		i = bucket_pop(q);
+		break;
+	default:
+		return -1;
+	}
+	--q->size;
+	q->node[i].next = q->free_node;
+	q->free_node = i;
+	return q->node[i].job;
+}
+
+/* order of the entries: by key, then by code */
+static int precedes(struct jobq *q, long int a, long int b)
+{
+	struct jobq_node *x = &q->node[a], *y = &q->node[b];
+
+	return (x->key < y->key)||((x->key == y->key)&&(x->code < y->code));
+}
+
+/* binary heap */
+
+static int binary_insert(struct jobq *q, long int n)
+{
+	int32_t *h;
+	long int i, parent, p;
+
+	if (q->size == q->heap_max) {
+		if ( !(h = realloc(q->heap, 2*q->heap_max*sizeof(int32_t))) ) return -1;
+		q->heap = h;
+		q->heap_max *= 2;
+	}
+	h = q->heap;
+
+	/* sift up */
+	i = q->size;
+	while (i) {
+		parent = (i - 1)/2;
+		p = h[parent];
+		if (precedes(q, p, n)) break;
+		h[i] = p;
+		i = parent;
+	}
+	h[i] = n;
+	return 0;
+}
+
+static long int binary_pop(struct jobq *q)
+{
+	int32_t *h = q->heap;
+	long int i, child, size, first, last, a, b;
+
+	first = h[0];
+	size = q->size - 1;
+	last = h[size];
+
+	/* sift down */
+	i = 0;
+	while ( (child = 2*i + 1) < size ) {
+		b = h[child];
+		if ( (child + 1 < size)&&precedes(q, a = h[child+1], b) ) {
+			++child;
+			b = a;
+		}
+		if (precedes(q, last, b)) break;
+		h[i] = b;
+		i = child;
+	}
+	h[i] = last;
+	return first;
+}
+
+/* pairing heap: a tree with the first entry at the root, the
+ * children of a node linked through next */
+
+static long int meld(struct jobq *q, long int a, long int b)
+{
+	struct jobq_node *n = q->node;
+
+	if (a < 0) return b;
+	if (b < 0) return a;
+	if (precedes(q, b, a)) {
+		n[b].next = -1;
+		n[a].next = n[b].child;
+		n[b].child = a;
+		return b;
+	}
+	n[a].next = -1;
+	n[b].next = n[a].child;
+	n[a].child = b;
+	return a;
+}
+
+/* remove the root, melding its children in pairs from the left, then
+ * the pairs from the right */
+static long int pairing_pop(struct jobq *q)
+{
+	struct jobq_node *n = q->node;
+	long int first = q->root;
+	long int a, b, rest, pairs, root;
+
+	pairs = -1;
+	for (a=n[first].child;a >= 0;a=rest) {
+		if ( (b = n[a].next) >= 0 ) rest = n[b].next;
+		else rest = -1;
+		a = meld(q, a, b);
+		n[a].next = pairs;
+		pairs = a;
+	}
+	root = -1;
+	for (a=pairs;a >= 0;a=rest) {
+		rest = n[a].next;
+		root = meld(q, root, a);
+	}
+	q->root = root;
+	return first;
+}
+
+/* bucket queue: one list per key, in order of insertion, so entries
+ * must be queued in order of code */
+
+static void bucket_insert(struct jobq *q, long int n)
+{
+	long int b = q->node[n].key - q->key_min;
+
+	if (q->bucket[b] >= 0) q->node[q->bucket_tail[b]].next = n;
+	else {
+		q->bucket[b] = n;
+		q->used[b/64] |= 1UL << (b%64);
+		if (b/64 < q->low) q->low = b/64;
+	}
+	q->bucket_tail[b] = n;
+}
+
+/* first non-empty bucket, the queue must not be empty */
+static long int bucket_first(struct jobq *q)
+{
+	while (!(q->used[q->low])) ++q->low;
+	return 64*q->low + __builtin_ctzl(q->used[q->low]);
+}
+
+static long int bucket_pop(struct jobq *q)
+{
+	long int b, first;
+
+	b = bucket_first(q);
+	first = q->bucket[b];
+	if ( (q->bucket[b] = q->node[first].next) < 0 ) q->used[b/64] &= ~(1UL << (b%64));
+	return first;
+}
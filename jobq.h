@@ -0,0 +1,58 @@
+/* job priority queue: waiting jobs ordered by an integer key, the
+ * earlier arrival (lower code) first among equal keys. Entries are
+ * nodes of a table, known and linked by their 32 bit index, so that a
+ * job holds the handle of its node in 4 bytes. */
+
+#ifndef JOBQ_H
+#define JOBQ_H
+
+#include <stdint.h>
+
+/* job priority queue backends: */
+#define JOBQ_HEAP 1
+#define JOBQ_PAIRING 2
+#define JOBQ_BUCKET 3
+
+struct jobq_node {
+	long int key;
+	long int code;
+	int32_t job; /* index of the job in its table */
+	int32_t child; /* pairing heap: first child, -1 if none */
+	int32_t next; /* pairing heap: next sibling, bucket queue: next in bucket, free list: next free */
+};
+
+struct jobq {
+	int kind;
+	long int size; /* number of queued jobs */
+
+	/* the nodes, those not in use linked from free_node */
+	struct jobq_node *node;
+	long int node_max;
+	int32_t free_node;
+
+	/* binary heap */
+	int32_t *heap;
+	long int heap_max;
+
+	/* pairing heap */
+	int32_t root;
+
+	/* bucket queue, one bucket per key in key_min..key_max */
+	int32_t *bucket;
+	int32_t *bucket_tail;
+	long int key_min;
+	long int nbuckets;
+	unsigned long int *used; /* non-empty buckets */
+	long int low; /* no word of used below this one has a bit set */
+};
+
+int jobq_kind(const char *name);
+const char *jobq_name(int kind);
+int jobq_init(struct jobq *q, int kind, long int key_min, long int key_max);
+void jobq_free(struct jobq *q);
+long int jobq_insert(struct jobq *q, long int key, long int code, long int job);
+void jobq_moved(struct jobq *q, long int node, long int job);
+long int jobq_min(struct jobq *q);
+long int jobq_pop(struct jobq *q);
+
+#endif
@@ -0,0 +1,125 @@
+/* job kernel benchmark: ticks per second of kernel_advance() over
+ * 10^4 to 10^7 live jobs with each kernel the processor runs, against
+ * the scalar one, and a check that they all list the same jobs
+ *
+ * usage: kernel-bench [live jobs ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "kernel.h"
+
+/* job states: */
+#define WAITING 1
+#define RUNNING 2
+#define SENDING_DATA 4
+
+/* one job in RUNNING_EVERY runs or sends, the others wait */
+#define RUNNING_EVERY 20
+
+/* ticks timed, scaled down with the number of jobs */
+#define TICK_JOBS 200000000L
+
+/* function declaration */
+double ticks_per_second();
+double seconds();
+
+/* kept so the compiler cannot drop the passes */
+long int sink = 0;
+
+/* jobs listed by the last run */
+long int listed;
+
+int main(int argc, char *argv[])
+{
+	static long int sizes[] = { 10000, 100000, 1000000, 10000000 };
+	double scalar, t;
+	long int n, scalar_listed;
+	int i, k, count, failed = 0;
+
+	count = (argc > 1) ? argc - 1 : 4;
+	printf("%10s %8s %14s %8s\n", "live jobs", "kernel", "ticks/s", "speedup");
+	for (i=0;i<count;++i) {
+		n = (argc > 1) ? atol(argv[i+1]) : sizes[i];
+		scalar = ticks_per_second(n,KERNEL_SCALAR);
+		scalar_listed = listed;
+		printf("%10li %8s %14.1f %7.1fx\n", n, kernel_name(KERNEL_SCALAR), scalar, 1.0);
+		for (k=KERNEL_SCALAR + 1;kernel_name(k);++k) {
+			if (!kernel_supported(k)) continue;
+			t = ticks_per_second(n,k);
+			printf("%10li %8s %14.1f %7.1fx%s\n", n, kernel_name(k), t, t/scalar,
+			    (listed == scalar_listed) ? "" : "  lists differ");
+			if (listed != scalar_listed) failed = 1;
+		}
+	}
+	return (failed||!sink) ? 1 : 0;
+}
+
+double seconds()
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+/* n jobs, mostly waiting, a few sending or running, restarted when they
+ * end to keep the population; listed sums the indexes of the jobs the
+ * kernel lists, as a checksum */
+double ticks_per_second(long int n, int kind)
+{
+	struct kernel_jobs t;
+	uint8_t *state = malloc(n*sizeof(uint8_t));
+	int *workload = malloc(n*sizeof(int));
+	int *send_data = malloc(n*sizeof(int));
+	int32_t *run_on = malloc(n*sizeof(int32_t));
+	int *level = malloc((n/RUNNING_EVERY + 1)*sizeof(int));
+	int32_t *sent = malloc(n*sizeof(int32_t));
+	int32_t *ended = malloc(n*sizeof(int32_t));
+	long int i, nsent, nended, ticks, tick;
+	double t0;
+
+	for (i=0;i<n;++i) {
+		state[i] = (i % RUNNING_EVERY) ? WAITING : (i/RUNNING_EVERY % 2) ? RUNNING : SENDING_DATA;
+		workload[i] = 50 + i % 950;
+		send_data[i] = i % 30;
+		run_on[i] = (state[i] == WAITING) ? -1 : i/RUNNING_EVERY;
+		level[i/RUNNING_EVERY] = 1 + i % 5;
+	}
+	t.n = n;
+	t.state = state;
+	t.workload = workload;
+	t.send_data = send_data;
+	t.run_on = run_on;
+	t.level = level;
+	t.sending = SENDING_DATA;
+	t.running = RUNNING;
+
+	ticks = TICK_JOBS/n;
+	listed = 0;
+	t0 = seconds();
+	for (tick=0;tick<ticks;++tick) {
+		kernel_advance(kind,&t,1,sent,&nsent,ended,&nended);
+		for (i=0;i<nsent;++i) {
+			send_data[sent[i]] = 30;
+			listed += sent[i];
+		}
+		for (i=0;i<nended;++i) {
+			workload[ended[i]] = 999;
+			listed += ended[i];
+		}
+		sink += nsent + nended;
+	}
+	t0 = seconds() - t0;
+
+	free(state);
+	free(workload);
+	free(send_data);
+	free(run_on);
+	free(level);
+	free(sent);
+	free(ended);
+	return ticks/t0;
+}
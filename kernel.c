@@ -0,0 +1,181 @@
+/* job kernels: the send_data of a sending job goes down by d, the
+ * workload of a running job by d times the level of its resource; a job
+ * is listed in sent when its send_data comes to 0 or below, in ended
+ * when its workload does, in order of index. The vector kernels take 8
+ * (AVX2) or 4 (SSE2) jobs at a time under masks of their states, pass
+ * over those with none sending or running, and list the ends from the
+ * bits of a compare. The scalar one runs anywhere, and is kept to check
+ * them against. */
+
+#include <string.h>
+#include "kernel.h"
+
+#if defined(__GNUC__)&&(defined(__x86_64__)||defined(__i386__))
+#define KERNEL_X86
+#include <immintrin.h>
+#endif
+
+/* what a running job k takes off its workload */
+#define STEP(t, k, d) ( ((t)->state[k] == (t)->running) ? (t)->level[(t)->run_on[k]]*(d) : 0 )
+
+/* function declaration */
+static void advance_scalar(struct kernel_jobs *t, long int from, int d, int32_t *sent, long int *nsent, int32_t *ended, long int *nended);
+#ifdef KERNEL_X86
+static void advance_sse2(struct kernel_jobs *t, int d, int32_t *sent, long int *nsent, int32_t *ended, long int *nended);
+static void advance_avx2(struct kernel_jobs *t, int d, int32_t *sent, long int *nsent, int32_t *ended, long int *nended);
+#endif
+
+int kernel_kind(const char *name)
+{
+	if (!strcmp(name,"scalar")) return KERNEL_SCALAR;
+	if (!strcmp(name,"sse2")) return KERNEL_SSE2;
+	if (!strcmp(name,"avx2")) return KERNEL_AVX2;
+	return 0;
+}
+
+const char *kernel_name(int kind)
+{
+	switch (kind) {
+	case KERNEL_SCALAR:
+		return "scalar";
+	case KERNEL_SSE2:
+		return "sse2";
+	case KERNEL_AVX2:
+		return "avx2";
+	default:
+		return NULL;
+	}
+}
+
+/* the processor runs the kernel */
+int kernel_supported(int kind)
+{
+	switch (kind) {
+	case KERNEL_SCALAR:
+		return 1;
+#ifdef KERNEL_X86
+	case KERNEL_SSE2:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse2");
+	case KERNEL_AVX2:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+#endif
+	default:
+		return 0;
+	}
+}
+
+int kernel_best(void)
+{
+	if (kernel_supported(KERNEL_AVX2)) return KERNEL_AVX2;
+	if (kernel_supported(KERNEL_SSE2)) return KERNEL_SSE2;
+	return KERNEL_SCALAR;
+}
+
+/* sent and ended must have room for every job of the table */
+void kernel_advance(int kind, struct kernel_jobs *t, int d, int32_t *sent, long int *nsent, int32_t *ended, long int *nended)
+{
+	*nsent = 0;
+	*nended = 0;
+	switch (kind) {
+#ifdef KERNEL_X86
+	case KERNEL_SSE2:
+		advance_sse2(t,d,sent,nsent,ended,nended);
+		break;
+	case KERNEL_AVX2:
+		advance_avx2(t,d,sent,nsent,ended,nended);
+		break;
+#endif
+	default:
+		advance_scalar(t,0L,d,sent,nsent,ended,nended);
+	}
+}
+
+/* the jobs from index from on */
+static void advance_scalar(struct kernel_jobs *t, long int from, int d, int32_t *sent, long int *nsent, int32_t *ended, long int *nended)
+{
+	long int j;
+
+	for (j=from;j<t->n;++j)
+		if (t->state[j] == t->sending) {
+			if ( (t->send_data[j] -= d) <= 0 ) sent[(*nsent)++] = j;
+		} else if (t->state[j] == t->running) {
+			if ( (t->workload[j] -= t->level[t->run_on[j]]*d) <= 0 ) ended[(*nended)++] = j;
+		}
+}
+
+#ifdef KERNEL_X86
+/* SSE2 has no gather: the levels of the 4 jobs are read one by one */
+__attribute__((target("sse2")))
+static void advance_sse2(struct kernel_jobs *t, int d, int32_t *sent, long int *nsent, int32_t *ended, long int *nended)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i dv = _mm_set1_epi32(d);
+	const __m128i sending = _mm_set1_epi32(t->sending);
+	const __m128i running = _mm_set1_epi32(t->running);
+	__m128i st, ms, mr, v;
+	long int j;
+	int s4, bits;
+
+	for (j=0;j + 4 <= t->n;j+=4) {
+		memcpy(&s4,t->state + j,4);
+		st = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(s4),zero),zero);
+		ms = _mm_cmpeq_epi32(st,sending);
+		mr = _mm_cmpeq_epi32(st,running);
+		if (!_mm_movemask_epi8(_mm_or_si128(ms,mr))) continue;
+
+		if (_mm_movemask_epi8(ms)) {
+			v = _mm_sub_epi32(_mm_loadu_si128((__m128i *)(t->send_data + j)),_mm_and_si128(ms,dv));
+			_mm_storeu_si128((__m128i *)(t->send_data + j),v);
+			bits = _mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(_mm_cmpgt_epi32(v,zero),ms)));
+			for (;bits;bits&=bits - 1) sent[(*nsent)++] = j + __builtin_ctz(bits);
+		}
+		if (_mm_movemask_epi8(mr)) {
+			v = _mm_set_epi32(STEP(t,j + 3,d),STEP(t,j + 2,d),STEP(t,j + 1,d),STEP(t,j,d));
+			v = _mm_sub_epi32(_mm_loadu_si128((__m128i *)(t->workload + j)),v);
+			_mm_storeu_si128((__m128i *)(t->workload + j),v);
+			bits = _mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(_mm_cmpgt_epi32(v,zero),mr)));
+			for (;bits;bits&=bits - 1) ended[(*nended)++] = j + __builtin_ctz(bits);
+		}
+	}
+	advance_scalar(t,j,d,sent,nsent,ended,nended);
+}
+
+/* the levels are gathered under the running mask, so that the run_on
+ * of the other jobs, -1 for waiting ones, is not followed */
+__attribute__((target("avx2")))
+static void advance_avx2(struct kernel_jobs *t, int d, int32_t *sent, long int *nsent, int32_t *ended, long int *nended)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i dv = _mm256_set1_epi32(d);
+	const __m256i sending = _mm256_set1_epi32(t->sending);
+	const __m256i running = _mm256_set1_epi32(t->running);
+	__m256i st, ms, mr, any, v;
+	long int j;
+	int bits;
+
+	for (j=0;j + 8 <= t->n;j+=8) {
+		st = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(t->state + j)));
+		ms = _mm256_cmpeq_epi32(st,sending);
+		mr = _mm256_cmpeq_epi32(st,running);
+		any = _mm256_or_si256(ms,mr);
+		if (_mm256_testz_si256(any,any)) continue;
+
+		if (!_mm256_testz_si256(ms,ms)) {
+			v = _mm256_sub_epi32(_mm256_loadu_si256((__m256i *)(t->send_data + j)),_mm256_and_si256(ms,dv));
+			_mm256_storeu_si256((__m256i *)(t->send_data + j),v);
+			bits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(_mm256_cmpgt_epi32(v,zero),ms)));
+			for (;bits;bits&=bits - 1) sent[(*nsent)++] = j + __builtin_ctz(bits);
+		}
+		if (!_mm256_testz_si256(mr,mr)) {
+			v = _mm256_mask_i32gather_epi32(zero,t->level,_mm256_loadu_si256((const __m256i *)(t->run_on + j)),mr,4);
+			v = _mm256_sub_epi32(_mm256_loadu_si256((__m256i *)(t->workload + j)),_mm256_mullo_epi32(v,dv));
+			_mm256_storeu_si256((__m256i *)(t->workload + j),v);
+			bits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(_mm256_cmpgt_epi32(v,zero),mr)));
+			for (;bits;bits&=bits - 1) ended[(*nended)++] = j + __builtin_ctz(bits);
+		}
+	}
+	advance_scalar(t,j,d,sent,nsent,ended,nended);
+}
+#endif
@@ -0,0 +1,34 @@
+/* job kernels: the sending and running jobs of a table advanced by a
+ * number of ticks, the jobs whose transfer or run ends listed by
+ * index, in a scalar loop or with SSE2 or AVX2 vectors, chosen at run
+ * time by what the processor has */
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <stdint.h>
+
+/* kernels: */
+#define KERNEL_SCALAR 1
+#define KERNEL_SSE2 2
+#define KERNEL_AVX2 3
+
+/* the job columns a kernel reads and writes */
+struct kernel_jobs {
+	long int n;
+	const uint8_t *state;
+	int *workload;
+	int *send_data;
+	const int32_t *run_on; /* resource index, read if running */
+	const int *level; /* of each resource */
+	int sending; /* the states a job sends data and runs in */
+	int running;
+};
+
+int kernel_kind(const char *name);
+const char *kernel_name(int kind);
+int kernel_supported(int kind);
+int kernel_best(void);
+void kernel_advance(int kind, struct kernel_jobs *t, int d, int32_t *sent, long int *nsent, int32_t *ended, long int *nended);
+
+#endif
@@ -0,0 +1,213 @@
+/* table layout benchmark: bytes per live job and resource of the
+ * columns of sim.c, with the 64 bit indices, int states and pointers to
+ * reservations and queue nodes it had and the 32 bit indices, byte
+ * states and 32 bit handles it has now, and ticks per second of the
+ * run_send() pass over the columns it reads, in both layouts
+ *
+ * usage: layout-bench [live jobs ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+/* job states: */
+#define WAITING 1
+#define RUNNING 2
+#define SENDING_DATA 4
+
+/* one job in RUNNING_EVERY runs or sends, the others wait */
+#define RUNNING_EVERY 20
+
+/* ticks timed, scaled down with the number of jobs */
+#define TICK_JOBS 100000000L
+
+/* a column of a table, its size in the two layouts, and whether the
+ * run_send() pass over the jobs reads it */
+struct column {
+	char *name;
+	int wide;
+	int compact;
+	int hot;
+};
+
+/* function declaration */
+void print_columns();
+double wide_ticks();
+double compact_ticks();
+double seconds();
+
+struct column job_columns[] = {
+	{ "code", sizeof(long int), sizeof(long int), 0 },
+	{ "state", sizeof(int), sizeof(uint8_t), 1 },
+	{ "workload", sizeof(int), sizeof(int), 1 },
+	{ "send_data", sizeof(int), sizeof(int), 1 },
+	{ "wait_time", sizeof(long int), sizeof(long int), 0 },
+	{ "wait_since", sizeof(long int), sizeof(long int), 0 },
+	{ "run_on", sizeof(long int), sizeof(int32_t), 1 },
+	{ "next_rsv", sizeof(void *), sizeof(int32_t), 0 },
+	{ "next_waiting", sizeof(long int), sizeof(int32_t), 0 },
+	{ "prev_waiting", sizeof(long int), sizeof(int32_t), 0 },
+	{ "node", sizeof(void *), sizeof(int32_t), 0 },
+	{ NULL, 0, 0, 0 }
+};
+struct column res_columns[] = {
+	{ "code", sizeof(long int), sizeof(long int), 0 },
+	{ "state", sizeof(int), sizeof(uint8_t), 0 },
+	{ "level", sizeof(int), sizeof(int), 1 },
+	{ "added", sizeof(long int), sizeof(long int), 0 },
+	{ "used_time", sizeof(float), sizeof(float), 0 },
+	{ "job", sizeof(long int), sizeof(int32_t), 0 },
+	{ "total_workload", sizeof(long int), sizeof(long int), 0 },
+	{ "first_rsv", sizeof(void *), sizeof(int32_t), 0 },
+	{ "last_rsv", sizeof(void *), sizeof(int32_t), 0 },
+	{ "next_free", sizeof(long int), sizeof(int32_t), 0 },
+	{ "prev_free", sizeof(long int), sizeof(int32_t), 0 },
+	{ "load_pos", sizeof(long int), sizeof(int32_t), 0 },
+	{ NULL, 0, 0, 0 }
+};
+
+/* kept so the compiler cannot drop the passes */
+long int sink = 0;
+
+int main(int argc, char *argv[])
+{
+	static long int sizes[] = { 10000, 100000, 1000000, 10000000 };
+	double before, after;
+	long int n;
+	int i, count;
+
+	print_columns("job",job_columns);
+	print_columns("resource",res_columns);
+	printf("\n");
+
+	count = (argc > 1) ? argc - 1 : 4;
+	printf("%10s %14s %14s %8s\n", "live jobs", "64 bit ticks/s", "32 bit ticks/s", "speedup");
+	for (i=0;i<count;++i) {
+		n = (argc > 1) ? atol(argv[i+1]) : sizes[i];
+		before = wide_ticks(n);
+		after = compact_ticks(n);
+		printf("%10li %14.1f %14.1f %7.1fx\n", n, before, after, after/before);
+	}
+	return sink ? 0 : 1;
+}
+
+/* bytes per live entry, of all the columns and of the hot ones, and
+ * the hot working set of a million entries */
+void print_columns(char *what, struct column *c)
+{
+	int wide = 0, compact = 0, wide_hot = 0, compact_hot = 0;
+
+	for (;c->name;++c) {
+		wide += c->wide;
+		compact += c->compact;
+		if (c->hot) {
+			wide_hot += c->wide;
+			compact_hot += c->compact;
+		}
+	}
+	printf("bytes per live %s: %i before, %i now; hot %i before, %i now (%.1f and %.1f MB a million)\n",
+	    what, wide, compact, wide_hot, compact_hot, wide_hot*1e6/(1 << 20), compact_hot*1e6/(1 << 20));
+}
+
+double seconds()
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+/* The same pass over each layout, written out twice for the types:
+ * mostly waiting jobs, a few sending or running, restarted when they
+ * end to keep the population. */
+
+double wide_ticks(long int n)
+{
+	int *state = malloc(n*sizeof(int));
+	int *workload = malloc(n*sizeof(int));
+	int *send_data = malloc(n*sizeof(int));
+	long int *run_on = malloc(n*sizeof(long int));
+	int *level = malloc((n/RUNNING_EVERY + 1)*sizeof(int));
+	long int i, j, r, ticks, t;
+	double t0;
+
+	for (i=0;i<n;++i) {
+		state[i] = (i % RUNNING_EVERY) ? WAITING : (i/RUNNING_EVERY % 2) ? RUNNING : SENDING_DATA;
+		workload[i] = 50 + i % 950;
+		send_data[i] = i % 30;
+		run_on[i] = i/RUNNING_EVERY;
+		level[i/RUNNING_EVERY] = 1 + i % 5;
+	}
+
+	ticks = TICK_JOBS/n;
+	t0 = seconds();
+	for (t=0;t<ticks;++t)
+		for (j=0;j<n;++j)
+			switch (state[j]) {
+			case SENDING_DATA:
+				if (--send_data[j] <= 0) send_data[j] = 30;
+				break;
+			case RUNNING:
+				r = run_on[j];
+				workload[j] -= level[r];
+				if (workload[j] <= 0) {
+					workload[j] = 999;
+					++sink;
+				}
+				break;
+			}
+	t0 = seconds() - t0;
+
+	free(state);
+	free(workload);
+	free(send_data);
+	free(run_on);
+	free(level);
+	return ticks/t0;
+}
+
+double compact_ticks(long int n)
+{
+	uint8_t *state = malloc(n*sizeof(uint8_t));
+	int *workload = malloc(n*sizeof(int));
+	int *send_data = malloc(n*sizeof(int));
+	int32_t *run_on = malloc(n*sizeof(int32_t));
+	int *level = malloc((n/RUNNING_EVERY + 1)*sizeof(int));
+	long int i, j, r, ticks, t;
+	double t0;
+
+	for (i=0;i<n;++i) {
+		state[i] = (i % RUNNING_EVERY) ? WAITING : (i/RUNNING_EVERY % 2) ? RUNNING : SENDING_DATA;
+		workload[i] = 50 + i % 950;
+		send_data[i] = i % 30;
+		run_on[i] = i/RUNNING_EVERY;
+		level[i/RUNNING_EVERY] = 1 + i % 5;
+	}
+
+	ticks = TICK_JOBS/n;
+	t0 = seconds();
+	for (t=0;t<ticks;++t)
+		for (j=0;j<n;++j)
+			switch (state[j]) {
+			case SENDING_DATA:
+				if (--send_data[j] <= 0) send_data[j] = 30;
+				break;
+			case RUNNING:
+				r = run_on[j];
+				workload[j] -= level[r];
+				if (workload[j] <= 0) {
+					workload[j] = 999;
+					++sink;
+				}
+				break;
+			}
+	t0 = seconds() - t0;
+
+	free(state);
+	free(workload);
+	free(send_data);
+	free(run_on);
+	free(level);
+	return ticks/t0;
+}
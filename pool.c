@@ -0,0 +1,62 @@
+/* pool allocator: a slab holds per_slab objects after a first slot
+ * that links the slabs together; pool_get() only calls malloc() when
+ * the free list is empty, so once the number of live objects stops
+ * growing, allocation is a pointer pop */
+
+#include <stdlib.h>
+#include "pool.h"
+
+void pool_init(struct pool *p, size_t size, long int per_slab)
+{
+	if (size < sizeof(void *)) size = sizeof(void *);
+	p->size = (size + sizeof(void *) - 1)/sizeof(void *)*sizeof(void *);
+	p->per_slab = per_slab;
+	p->free = NULL;
+	p->slabs = NULL;
+	p->slab_count = 0;
+}
+
+/* returns NULL if out of memory */
+void *pool_get(struct pool *p)
+{
+	char *slab, *obj;
+	long int i;
+
+	if (!(p->free)) {
+		if ( !(slab = malloc((p->per_slab + 1)*p->size)) ) return NULL;
+		*(void **)slab = p->slabs;
+		p->slabs = slab;
+		++p->slab_count;
+
+		/* link the objects in address order, so they are handed out that way */
+		obj = slab + p->size;
+		for (i=1;i<p->per_slab;++i) {
+			*(void **)obj = obj + p->size;
+			obj += p->size;
+		}
+		*(void **)obj = NULL;
+		p->free = slab + p->size;
+	}
+	obj = p->free;
+	p->free = *(void **)obj;
+	return obj;
+}
+
+void pool_put(struct pool *p, void *obj)
+{
+	*(void **)obj = p->free;
+	p->free = obj;
+}
+
+/* release all the slabs, and with them every object of the pool */
+void pool_free(struct pool *p)
+{
+	void *slab;
+
+	while ((slab = p->slabs)) {
+		p->slabs = *(void **)slab;
+		free(slab);
+	}
+	p->free = NULL;
+	p->slab_count = 0;
+}
@@ -0,0 +1,22 @@
+/* pool allocator: objects of one size carved from contiguous slabs,
+ * freed objects kept on a free list for reuse */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+struct pool {
+	size_t size; /* object size, rounded up to a pointer */
+	long int per_slab; /* objects in a slab */
+	void *free; /* free objects, linked through their first word */
+	void *slabs; /* slabs allocated, linked through their first word */
+	long int slab_count; /* number of slabs allocated */
+};
+
+void pool_init(struct pool *p, size_t size, long int per_slab);
+void *pool_get(struct pool *p);
+void pool_put(struct pool *p, void *obj);
+void pool_free(struct pool *p);
+
+#endif
@@ -0,0 +1,190 @@
+/* regression benchmark: runs grid-sim with the legacy random number
+ * generator over the configurations of the golden outputs, timing each
+ * run and checking that its statistics are the golden ones, line for
+ * line, so that a faster simulator can be shown to behave the same
+ *
+ * Golden outputs are named policy-sim.out.add_job_prob.txt, as the
+ * outputs of the old simulators are; golden/ holds those of grid-sim.
+ * -e, -q and -k are passed on to grid-sim, to check the backends and
+ * the job kernels.
+ *
+ * usage: regress-bench [-x grid-sim] [-g golden directory] [-e fel]
+ *	[-q jobq] [-k kernel] [policy ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <limits.h>
+#include <time.h>
+#include <spawn.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+struct golden {
+	char *policy;
+	char *add_job_prob;
+};
+
+extern char **environ;
+
+/* function declaration */
+void usage();
+int selected();
+int simulate();
+long int compare();
+double seconds();
+
+struct golden goldens[] = {
+	{ "fcfs", "800" }, { "fcfs", "900" },
+	{ "lwf", "800" }, { "lwf", "900" },
+	{ "mixed", "800" }, { "mixed", "900" },
+	{ "ar", "50" }, { "ar", "400" }, { "ar", "600" }, { "ar", "800" }, { "ar", "900" },
+	{ NULL, NULL }
+};
+
+char *program = "./grid-sim";
+char *directory = "golden";
+char **policies;
+int npolicies;
+char *options[12]; /* passed on to grid-sim */
+int noptions;
+
+int main(int argc, char *argv[])
+{
+	char dir[] = "/tmp/regress-bench.XXXXXX";
+	char golden[PATH_MAX], output[PATH_MAX];
+	struct golden *g;
+	double elapsed, total = 0;
+	long int line;
+	int c, status, failed = 0;
+
+	while ( (c = getopt(argc,argv,"x:g:e:q:k:")) != -1 )
+		switch (c) {
+		case 'x':
+			program = optarg;
+			break;
+		case 'g':
+			directory = optarg;
+			break;
+		case 'e':
+		case 'q':
+		case 'k':
+			if (noptions == 12) usage(argv[0]);
+			options[noptions++] = (c == 'e') ? "-e" : (c == 'q') ? "-q" : "-k";
+			options[noptions++] = optarg;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	policies = argv + optind;
+	npolicies = argc - optind;
+	if (!mkdtemp(dir)) {
+		perror(dir);
+		exit(errno);
+	}
+
+	for (g=goldens;g->policy;++g) {
+		if (!selected(g->policy)) continue;
+		snprintf(golden,sizeof(golden),"%s/%s-sim.out.%s.txt",directory,g->policy,g->add_job_prob);
+		snprintf(output,sizeof(output),"%s/%s-sim.out.%s.txt",dir,g->policy,g->add_job_prob);
+		if (access(golden,R_OK)) continue;
+		printf("%-6s %4s ",g->policy,g->add_job_prob);
+		fflush(stdout);
+		elapsed = seconds();
+		status = simulate(g,output);
+		elapsed = seconds() - elapsed;
+		total += elapsed;
+		printf("%8.2fs  ",elapsed);
+		if (status) {
+			printf("failed (%i)\n",status);
+			++failed;
+		} else if ( (line = compare(golden,output)) ) {
+			printf("differs from line %li\n",line);
+			++failed;
+		} else printf("same\n");
+		unlink(output);
+	}
+	rmdir(dir);
+	printf("%-11s %8.2fs  %s\n","total",total,failed ? "FAILED" : "all the same");
+	return failed ? 1 : 0;
+}
+
+void usage(char *name)
+{
+	fprintf(stderr,"usage: %s [-x grid-sim] [-g golden directory] [-e fel] [-q jobq] [-k kernel] [policy ...]\n",name);
+	exit(EINVAL);
+}
+
+/* policy is one of those asked for, or none were */
+int selected(char *policy)
+{
+	int i;
+
+	for (i=0;i<npolicies;++i)
+		if (!strcmp(policies[i],policy)) return 1;
+	return !npolicies;
+}
+
+/* run the simulation of a golden output in the foreground, writing to
+ * output; returns its exit status */
+int simulate(struct golden *g, char *output)
+{
+	char setting[64];
+	char *argv[32];
+	pid_t pid;
+	int argc = 0, status, i;
+
+	snprintf(setting,sizeof(setting),"add_job_prob=%s",g->add_job_prob);
+	argv[argc++] = program;
+	argv[argc++] = "-F";
+	argv[argc++] = "-r";
+	argv[argc++] = "legacy";
+	argv[argc++] = "-p";
+	argv[argc++] = setting;
+	for (i=0;i<noptions;++i)
+		argv[argc++] = options[i];
+	argv[argc++] = "-o";
+	argv[argc++] = output;
+	argv[argc++] = g->policy;
+	argv[argc] = NULL;
+
+	if ( (errno = posix_spawn(&pid,program,NULL,NULL,argv,environ)) ) return errno;
+	while ( (waitpid(pid,&status,0) < 0)&&(errno == EINTR) );
+	return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+
+/* returns 0 if the files are the same, or the first line they differ
+ * at, counting a missing file as differing from line 1 */
+long int compare(char *golden, char *output)
+{
+	char a[256], b[256];
+	FILE *fa, *fb;
+	char *ra, *rb;
+	long int line = 1;
+
+	fa = fopen(golden,"r");
+	fb = fopen(output,"r");
+	if ( fa&&fb )
+		for (;;++line) {
+			ra = fgets(a,sizeof(a),fa);
+			rb = fgets(b,sizeof(b),fb);
+			if ( !ra&&!rb ) {
+				line = 0;
+				break;
+			}
+			if ( !ra||!rb||strcmp(a,b) ) break;
+		}
+	if (fa) fclose(fa);
+	if (fb) fclose(fb);
+	return line;
+}
+
+double seconds()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+}
@@ -0,0 +1,83 @@
+/* random number benchmark: numbers from 0 to 999, as the simulator
+ * rolls them, from glibc random(), random_r() on a state of its own
+ * and the streams of rng.c, xoshiro one at a time and in batches and
+ * legacy one at a time
+ *
+ * usage: rng-bench [numbers] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "rng.h"
+
+/* numbers made per batch by rng_fill() */
+#define FILL 4096
+
+/* function declaration */
+double elapsed();
+
+/* rolls are summed, so that they are not optimized away */
+unsigned long int sum;
+
+int main(int argc, char *argv[])
+{
+	static uint64_t out[FILL];
+	static char state[128];
+	struct random_data data;
+	struct rng g;
+	struct timespec t;
+	long int n, i, k;
+	int32_t x;
+
+	n = (argc > 1) ? atol(argv[1]) : 100000000;
+
+	srandom(1);
+	elapsed(&t);
+	for (i=0;i<n;++i)
+		sum += random() % 1000;
+	printf("%-12s %6.2fns\n", "random", elapsed(&t)/n);
+
+	memset(&data, 0, sizeof(data));
+	initstate_r(1, state, sizeof(state), &data);
+	elapsed(&t);
+	for (i=0;i<n;++i) {
+		random_r(&data, &x);
+		sum += x % 1000;
+	}
+	printf("%-12s %6.2fns\n", "random_r", elapsed(&t)/n);
+
+	rng_seed(&g, RNG_XOSHIRO, 1, 0);
+	elapsed(&t);
+	for (i=0;i<n;++i)
+		sum += RNG_BELOW(&g, 1000);
+	printf("%-12s %6.2fns\n", "rng", elapsed(&t)/n);
+
+	rng_seed(&g, RNG_LEGACY, 1, 0);
+	elapsed(&t);
+	for (i=0;i<n;++i)
+		sum += RNG_BELOW(&g, 1000);
+	printf("%-12s %6.2fns\n", "rng legacy", elapsed(&t)/n);
+
+	rng_seed(&g, RNG_XOSHIRO, 1, 0);
+	elapsed(&t);
+	for (i=0;i<n;i+=FILL) {
+		rng_fill(&g, out, FILL);
+		for (k=0;k<FILL;++k)
+			sum += ((out[k] >> 32)*1000) >> 32;
+	}
+	printf("%-12s %6.2fns\n", "rng_fill", elapsed(&t)/n);
+	return (sum == 1);
+}
+
+/* nanoseconds since the last call, t holding the time of the last call */
+double elapsed(struct timespec *t)
+{
+	struct timespec now;
+	double ns;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ns = (now.tv_sec - t->tv_sec)*1e9 + (now.tv_nsec - t->tv_nsec);
+	*t = now;
+	return ns;
+}
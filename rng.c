@@ -0,0 +1,178 @@
+/* xoshiro256** (Blackman and Vigna), the seed starting a sequence
+ * through splitmix64 and the lanes of its streams taking it up 2^128
+ * numbers apart, lane l of stream k after k*RNG_LANES + l jumps, so
+ * that no two of them overlap; and glibc's random() TYPE_3 generator,
+ * the same sequence for every stream */
+
+#include <string.h>
+#include "rng.h"
+
+#define ROTL(x, k) ( ((x) << (k))|((x) >> (64 - (k))) )
+
+/* function declaration */
+static uint64_t splitmix64(uint64_t *x);
+static void jump(uint64_t *s);
+static void step(struct rng *g, uint64_t *out, long int n);
+static void step_legacy(struct rng *g, uint64_t *out, long int n);
+
+int rng_kind(const char *name)
+{
+	if (!strcmp(name,"xoshiro")) return RNG_XOSHIRO;
+	if (!strcmp(name,"legacy")) return RNG_LEGACY;
+	return 0;
+}
+
+const char *rng_name(int kind)
+{
+	switch (kind) {
+	case RNG_XOSHIRO:
+		return "xoshiro";
+	case RNG_LEGACY:
+		return "legacy";
+	default:
+		return NULL;
+	}
+}
+
+static uint64_t splitmix64(uint64_t *x)
+{
+	uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+
+	z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/* advance a xoshiro state by 2^128 numbers */
+static void jump(uint64_t *s)
+{
+	static const uint64_t poly[4] = {
+		0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+	};
+	uint64_t j[4] = { 0, 0, 0, 0 }, t;
+	int i, b, k;
+
+	for (i=0;i<4;++i)
+		for (b=0;b<64;++b) {
+			if (poly[i] & (1ULL << b))
+				for (k=0;k<4;++k) j[k] ^= s[k];
+			t = s[1] << 17;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = ROTL(s[3], 45);
+		}
+	memcpy(s, j, sizeof(j));
+}
+
+/* legacy generators take the low 32 bits of the seed, as srandom()
+ * does, and ignore the stream */
+void rng_seed(struct rng *g, int kind, uint64_t seed, uint64_t stream)
+{
+	uint64_t x = seed, s[4], k;
+	int32_t word, hi, lo;
+	int i, l;
+
+	g->kind = kind;
+	g->next = RNG_BATCH;
+	if (kind == RNG_LEGACY) {
+		/* srandom_r(): r[i] = 16807*r[i-1] % (2^31 - 1), by Schrage's
+		 * method, then 310 numbers thrown away */
+		word = (uint32_t)seed ? (int32_t)(uint32_t)seed : 1;
+		g->r[0] = word;
+		for (i=1;i<RNG_DEGREE;++i) {
+			hi = word/127773;
+			lo = word%127773;
+			word = 16807*lo - 2836*hi;
+			if (word < 0) word += 2147483647;
+			g->r[i] = word;
+		}
+		g->front = RNG_SEP;
+		g->rear = 0;
+		for (i=0;i<10*RNG_DEGREE;++i)
+			step_legacy(g, &x, 1);
+		return;
+	}
+
+	for (i=0;i<4;++i)
+		s[i] = splitmix64(&x);
+	for (k=0;k<stream*RNG_LANES;++k)
+		jump(s);
+	for (l=0;l<RNG_LANES;++l) {
+		for (i=0;i<4;++i)
+			g->s[i][l] = s[i];
+		jump(s);
+	}
+}
+
+/* n numbers of the lanes, a round of all lanes at a time; n is a
+ * multiple of RNG_LANES */
+static void step(struct rng *g, uint64_t *out, long int n)
+{
+	uint64_t s0[RNG_LANES], s1[RNG_LANES], s2[RNG_LANES], s3[RNG_LANES], t;
+	long int k;
+	int l;
+
+	memcpy(s0, g->s[0], sizeof(s0));
+	memcpy(s1, g->s[1], sizeof(s1));
+	memcpy(s2, g->s[2], sizeof(s2));
+	memcpy(s3, g->s[3], sizeof(s3));
+	for (k=0;k<n;k+=RNG_LANES)
+		for (l=0;l<RNG_LANES;++l) {
+			out[k + l] = ROTL(s1[l]*5, 7)*9;
+			t = s1[l] << 17;
+			s2[l] ^= s0[l];
+			s3[l] ^= s1[l];
+			s1[l] ^= s2[l];
+			s0[l] ^= s3[l];
+			s2[l] ^= t;
+			s3[l] = ROTL(s3[l], 45);
+		}
+	memcpy(g->s[0], s0, sizeof(s0));
+	memcpy(g->s[1], s1, sizeof(s1));
+	memcpy(g->s[2], s2, sizeof(s2));
+	memcpy(g->s[3], s3, sizeof(s3));
+}
+
+/* n numbers of random_r(), without its lock or its checks */
+static void step_legacy(struct rng *g, uint64_t *out, long int n)
+{
+	int front = g->front, rear = g->rear;
+	long int k;
+
+	for (k=0;k<n;++k) {
+		out[k] = (g->r[front] += g->r[rear]) >> 1;
+		if (++front == RNG_DEGREE) front = 0;
+		if (++rear == RNG_DEGREE) rear = 0;
+	}
+	g->front = front;
+	g->rear = rear;
+}
+
+/* make a new batch, returning its first number */
+uint64_t rng_refill(struct rng *g)
+{
+	if (g->kind == RNG_LEGACY) step_legacy(g, g->batch, RNG_BATCH);
+	else step(g, g->batch, RNG_BATCH);
+	g->next = 1;
+	return g->batch[0];
+}
+
+/* the next n numbers of the stream, the rest of the batch first */
+void rng_fill(struct rng *g, uint64_t *out, long int n)
+{
+	long int k;
+
+	for (;(n > 0)&&(g->next < RNG_BATCH);--n)
+		*out++ = g->batch[g->next++];
+	if (g->kind == RNG_LEGACY) {
+		step_legacy(g, out, n);
+		return;
+	}
+	k = n/RNG_LANES*RNG_LANES;
+	step(g, out, k);
+	for (out+=k,n-=k;n > 0;--n)
+		*out++ = RNG_NEXT(g);
+}
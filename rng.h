@@ -0,0 +1,47 @@
+/* random number streams: xoshiro256**, each stream RNG_LANES
+ * generators stepped side by side, so that a batch of numbers is made
+ * in a loop the compiler can vectorize, and handed out one at a time;
+ * or, to reproduce runs made with glibc random(), its TYPE_3 additive
+ * feedback generator, as srandom() seeds it */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+/* generators: */
+#define RNG_XOSHIRO 1
+#define RNG_LEGACY 2
+
+#define RNG_LANES 4
+#define RNG_BATCH 256 /* numbers made at a time, a multiple of RNG_LANES */
+
+/* TYPE_3: r[i] = r[i-31] + r[i-3], the numbers being r[i] >> 1 */
+#define RNG_DEGREE 31
+#define RNG_SEP 3
+
+struct rng {
+	int kind;
+	uint64_t s[4][RNG_LANES]; /* xoshiro: state word i of each lane */
+	uint32_t r[RNG_DEGREE]; /* legacy: the last RNG_DEGREE r[i] */
+	int front; /* legacy: place of r[i-3] */
+	int rear; /* legacy: place of r[i-31] */
+	uint64_t batch[RNG_BATCH];
+	int next; /* next number of the batch to hand out */
+};
+
+/* The next number of a stream, and one from 0 to n - 1 (n below
+ * 2^31), without a call but once a batch. xoshiro numbers are 64 bit,
+ * scaled down by their high half; legacy ones are 31 bit, taken modulo
+ * n as random() % n was. */
+#define RNG_NEXT(g) ( ((g)->next < RNG_BATCH) ? (g)->batch[(g)->next++] : rng_refill(g) )
+#define RNG_BELOW(g, n) ( ((g)->kind == RNG_LEGACY) ? (long int)(RNG_NEXT(g) % (uint64_t)(n)) \
+    : (long int)(((RNG_NEXT(g) >> 32)*(uint64_t)(n)) >> 32) )
+
+int rng_kind(const char *name);
+const char *rng_name(int kind);
+void rng_seed(struct rng *g, int kind, uint64_t seed, uint64_t stream);
+uint64_t rng_refill(struct rng *g);
+void rng_fill(struct rng *g, uint64_t *out, long int n);
+
+#endif
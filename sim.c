@@ -0,0 +1,1451 @@
+/* simulation of Grid scheduling algorithms:
+ * First-Come, First-Serve (FCFS), Least Work First (LWF),
+ * mixed (LWF+FCFS) and scheduling with Advance Reservations (AR),
+ * as a library (see sim.h) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <unistd.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "fel.h"
+#include "jobq.h"
+#include "kernel.h"
+#include "rng.h"
+#include "sim.h"
+#include "stats.h"
+
+/* scheduling policies: */
+#define FCFS SIM_FCFS
+#define LWF SIM_LWF
+#define MIXED SIM_MIXED
+#define AR SIM_AR
+
+/* resource states: */
+#define AVAILABLE 1
+#define USED 2
+#define LEAVING 3
+#define RECEIVING_DATA 4
+#define HAS_JOBS 5 /* AR: has reservations */
+#define NO_ACCEPT_JOBS 6 /* AR: leaves when its reservations are run */
+
+/* job states: */
+#define WAITING 1
+#define RUNNING 2
+#define DONE 3
+#define SENDING_DATA 4
+#define WAITING_TO_SEND_DATA 5 /* AR: reserved, resource busy sending */
+#define READY_TO_RUN 6 /* AR: data sent, resource busy running */
+
+/* states are numbered from 1 to STATES - 1 */
+#define STATES 7
+
+/* job states counted as waiting time: WAITING, and for AR
+ * WAITING_TO_SEND_DATA and READY_TO_RUN */
+#define IS_WAITING(state) ( ((state) == WAITING)||((state) == WAITING_TO_SEND_DATA)||((state) == READY_TO_RUN) )
+
+/* The parameters below are defaults, set at run time with sim_set()
+ * (-c and -p of grid-sim). Built with -DFIXED_CONFIG, the simulations
+ * run with these values as constants the compiler can fold into the
+ * loop, and refuse others. */
+
+/* interval in seconds between scheduling decisions
+ * set to 0 if no interval wished */
+#define DEFAULT_INTERVAL 0
+
+/* when MAX_JOBS jobs are done, simulation ends */
+#define DEFAULT_MAX_JOBS 100000
+
+/* every RECORD_INTERVAL jobs, record mean usage of resources */
+#define DEFAULT_RECORD_INTERVAL 500
+
+/* This defines the probability by which a resource leaves
+ * the cluster when it completes a job.
+ * The probability is calculated R_PROB/1000.
+ * example:if RL_PROB=500, then a resource has 50% chance
+ * of leaving the cluster when it completes a job */
+#define DEFAULT_RL_PROB 300
+
+/* probability to add a resource */
+#define DEFAULT_ADD_RESOURCE_PROB 50
+
+/* probability to add a job */
+#define DEFAULT_ADD_JOB_PROB 800
+
+/* these are the weights of the 2 strategies of mixed scheduling */
+#define DEFAULT_FCFS_W 1
+#define DEFAULT_LWF_W 1
+
+#ifdef FIXED_CONFIG
+#define INTERVAL DEFAULT_INTERVAL
+#define MAX_JOBS DEFAULT_MAX_JOBS
+#define RECORD_INTERVAL DEFAULT_RECORD_INTERVAL
+#define RL_PROB DEFAULT_RL_PROB
+#define ADD_RESOURCE_PROB DEFAULT_ADD_RESOURCE_PROB
+#define ADD_JOB_PROB DEFAULT_ADD_JOB_PROB
+#define FCFS_W DEFAULT_FCFS_W
+#define LWF_W DEFAULT_LWF_W
+#else
+#define INTERVAL (sim->config.interval)
+#define MAX_JOBS (sim->config.max_jobs)
+#define RECORD_INTERVAL (sim->config.record_interval)
+#define RL_PROB (sim->config.rl_prob)
+#define ADD_RESOURCE_PROB (sim->config.add_resource_prob)
+#define ADD_JOB_PROB (sim->config.add_job_prob)
+#define FCFS_W (sim->config.fcfs_w)
+#define LWF_W (sim->config.lwf_w)
+#endif
+
+/* seed of the random number streams */
+#define DEFAULT_SEED 1
+
+/* random number streams of a simulation, one per purpose, so that
+ * changing how one is used leaves the others as they were; with the
+ * legacy generator they are all one, drawn from in the order the
+ * simulators called random(), to reproduce their runs */
+#define ARRIVAL 0 /* add_remove() rolls */
+#define WORKLOAD 1
+#define SEND_DATA 2
+#define LEVEL 3
+#define DEPARTURE 4 /* resources leaving after a job */
+#define STREAMS 5
+
+/* a number from 0 to n - 1 of a stream */
+#define ROLL(s, n) RNG_BELOW(sim->stream[s], n)
+
+/* jobs, resources and list indexes allocated at a time */
+#define SLAB 4096
+
+/* Jobs and resources are kept in tables of columns, one array per
+ * field, so that the passes over them run through memory in order and
+ * read only the fields they use: the pass of run_send() over the jobs
+ * reads state, workload, send_data and run_on, 13 bytes a job. An
+ * entry is known by its index, 32 bit, as are the links between
+ * entries, the reservations of AR and the nodes of the job queue, and
+ * states fit in a byte; removing one moves the last entry of the table
+ * into its place. */
+
+struct job_table {
+	long int n; /* number of jobs */
+	long int max; /* room in the columns */
+	long int *code;
+	uint8_t *state;
+	int *workload;
+	int *send_data;
+	long int *wait_time; /* ticks waited before the current wait */
+	long int *wait_since; /* tick the current wait began at */
+	int32_t *run_on; /* resource index, -1 if none */
+	int32_t *next_rsv; /* AR: job reserved next on the same resource, -1 if none */
+	int32_t *next_waiting; /* waiting queue links */
+	int32_t *prev_waiting;
+	int32_t *node; /* LWF, mixed: node in the ranked queue, -1 if none */
+};
+
+struct res_table {
+	long int n; /* number of resources */
+	long int max; /* room in the columns */
+	long int *code;
+	uint8_t *state;
+	int *level;
+	long int *added; /* tick it was added at, its total time counting from the next */
+	float *used_time;
+	int32_t *job; /* index of the job sent to or run, -1 if none */
+	long int *total_workload; /* AR: workload of reserved jobs */
+	int32_t *first_rsv; /* AR: first job reserved, the one it runs or will, -1 if none */
+	int32_t *last_rsv; /* AR: last job reserved, if any */
+	int32_t *next_free; /* free resource list links */
+	int32_t *prev_free;
+	int32_t *load_pos; /* AR: place in the load heap, -1 if not in it */
+};
+
+/* table entries linked through a pair of next/prev columns */
+struct queue {
+	long int first; /* -1 if empty */
+	long int last;
+	long int n;
+};
+
+/* list of job or resource indexes */
+struct index_list {
+	long int n;
+	long int max;
+	int32_t *index;
+};
+
+/* a parameter of the configuration, its place in struct sim_config,
+ * its built-in and valid values */
+struct parameter {
+	char *name;
+	size_t offset;
+	long int built_in;
+	int fixed; /* a constant in FIXED_CONFIG builds */
+	long int min;
+	long int max;
+};
+
+#define PARAMETER(c, p) (*(long int *)((char *)(c) + (p)->offset))
+
+/* a backend a setting can choose by name */
+struct backend {
+	char *name;
+	size_t offset;
+	int (*kind)(const char *name);
+	const char *(*kind_name)(int kind);
+};
+
+#define BACKEND(c, b) (*(int *)((char *)(c) + (b)->offset))
+
+struct policy {
+	char *name;
+	int kind;
+	int (*simulate)(struct simulation *sim, long int events, long int until);
+};
+
+/* A simulation, with all it changes as it runs, so that several can
+ * run side by side in a process. The functions of the simulation take
+ * it as their first argument. */
+struct simulation {
+	struct sim_config config;
+	struct policy *policy; /* policy being simulated */
+	struct job_table jobs; /* all jobs submitted and not yet removed */
+	struct res_table res; /* all resources added and not yet removed */
+	long int resource_number; /* total number of resources added */
+	long int job_number; /* total number of jobs submitted */
+	float mean_usage; /* mean value of resource usage */
+	double mean_wait_time; /* mean waiting time for jobs to be scheduled */
+	long int wait_sum; /* wait_time of all jobs */
+	long int since_sum; /* wait_since of waiting jobs */
+	long int resources_gone; /* number of resources gone */
+	long int jobs_done; /* number of jobs done */
+	int done; /* MAX_JOBS jobs are done */
+	int error; /* errno of a failure the simulation cannot go on from, 0 if none */
+	int next_roll; /* add_remove() roll drawn ahead for the coming tick, 0 if none */
+	long int now; /* current tick */
+	struct fel events; /* transfers and runs to end, by the tick they end at */
+	int pending; /* the coming tick has to run, whatever the events */
+	struct index_list sent; /* jobs done sending in run_send() */
+	struct index_list finished; /* jobs (AR: resources) done in run_send() */
+	struct index_list done_jobs; /* jobs set DONE in a tick, to count in traceall() and remove */
+	struct index_list leaving; /* resources set LEAVING in a tick, to count in traceall() and remove */
+	struct queue waiting; /* WAITING jobs, in order of arrival */
+	struct queue free_res; /* AVAILABLE resources, in order of arrival */
+	long int jobs_in[STATES]; /* number of jobs in each state */
+	long int res_in[STATES]; /* number of resources in each state */
+	struct index_list load; /* AR: resources accepting jobs, a heap by total_workload */
+	struct jobq ranked; /* LWF, mixed: waiting jobs in the order they are picked */
+	struct rng rng[STREAMS]; /* random number generators, seeded by reset() */
+	struct rng *stream[STREAMS]; /* the generator of each stream */
+	struct stats_file out; /* where record_mean_usage() writes, if opened */
+	void (*record)(void *, struct sim_stats *); /* called by record_mean_usage(), if set */
+	void *record_arg;
+	volatile sig_atomic_t report_requested; /* sim_request_report() was called */
+	volatile sig_atomic_t stop_requested; /* sim_stop() was called */
+};
+
+/* function declaration */
+static int reset(struct simulation *sim);
+static void add_remove(struct simulation *sim);
+static void run_send(struct simulation *sim);
+static void run_send_ar(struct simulation *sim);
+static void schedule_fcfs(struct simulation *sim);
+static void schedule_lwf(struct simulation *sim);
+static void schedule_mixed(struct simulation *sim);
+static void schedule_ar(struct simulation *sim);
+static void add_res(struct simulation *sim);
+static void add_job(struct simulation *sim);
+static int grow(void *column, long int max, size_t size);
+static void remove_job(struct simulation *sim, long int j);
+static void remove_res(struct simulation *sim, long int r);
+static void remove_done_jobs(struct simulation *sim);
+static void remove_leaving_resources(struct simulation *sim);
+static void traceall(struct simulation *sim);
+static void record_mean_usage(struct simulation *sim);
+static double wait_mean(struct simulation *sim);
+static void add_event(struct simulation *sim, long int time, void *data);
+static void add_index(struct simulation *sim, struct index_list *l, long int i);
+static int fit_index(struct index_list *l, long int n);
+static int run_kernel(struct simulation *sim, long int d);
+static void queue_append(struct queue *q, int32_t *next, int32_t *prev, long int i);
+static void queue_insert(struct queue *q, int32_t *next, int32_t *prev, long int i, long int *code);
+static void queue_remove(struct queue *q, int32_t *next, int32_t *prev, long int i);
+static void queue_moved(struct queue *q, int32_t *next, int32_t *prev, long int i);
+static void rsv_moved(struct simulation *sim, long int from, long int to);
+static int lighter(struct simulation *sim, long int a, long int b);
+static void load_insert(struct simulation *sim, long int r);
+static void load_remove(struct simulation *sim, long int r);
+static void load_update(struct simulation *sim, long int r);
+static void load_place(struct simulation *sim, long int r, long int i);
+static void sort_by_code(struct index_list *l, long int *code);
+static void sort_by_index(struct index_list *l);
+static void set_job_state(struct simulation *sim, long int j, int state);
+static void set_res_state(struct simulation *sim, long int r, int state);
+static void report(struct simulation *sim);
+static long int skip_quiet_ticks(struct simulation *sim, int policy, long int limit);
+static long int next_event(struct simulation *sim, int policy);
+static void advance(struct simulation *sim, int policy, long int d);
+
+/* global variables */
+static const struct sim_config default_config = {
+	DEFAULT_INTERVAL, DEFAULT_MAX_JOBS, DEFAULT_RECORD_INTERVAL, DEFAULT_RL_PROB,
+	DEFAULT_ADD_RESOURCE_PROB, DEFAULT_ADD_JOB_PROB, DEFAULT_FCFS_W, DEFAULT_LWF_W,
+	DEFAULT_SEED, FCFS, FEL_CALENDAR, JOBQ_BUCKET, RNG_XOSHIRO, 0
+};
+static const struct parameter parameter_table[] = {
+	{ "interval", offsetof(struct sim_config, interval), DEFAULT_INTERVAL, 1, 0, 86400 },
+	{ "max_jobs", offsetof(struct sim_config, max_jobs), DEFAULT_MAX_JOBS, 1, 1, LONG_MAX },
+	{ "record_interval", offsetof(struct sim_config, record_interval), DEFAULT_RECORD_INTERVAL, 1, 1, LONG_MAX },
+	{ "rl_prob", offsetof(struct sim_config, rl_prob), DEFAULT_RL_PROB, 1, 0, 1000 },
+	{ "add_resource_prob", offsetof(struct sim_config, add_resource_prob), DEFAULT_ADD_RESOURCE_PROB, 1, 0, 1000 },
+	{ "add_job_prob", offsetof(struct sim_config, add_job_prob), DEFAULT_ADD_JOB_PROB, 1, 0, 1000 },
+	{ "fcfs_w", offsetof(struct sim_config, fcfs_w), DEFAULT_FCFS_W, 1, 0, 1000000 },
+	{ "lwf_w", offsetof(struct sim_config, lwf_w), DEFAULT_LWF_W, 1, 0, 1000000 },
+	{ "seed", offsetof(struct sim_config, seed), DEFAULT_SEED, 0, 0, LONG_MAX },
+	{ NULL, 0, 0, 0, 0, 0 }
+};
+static const struct backend backend_table[] = {
+	{ "fel", offsetof(struct sim_config, fel), fel_kind, fel_name },
+	{ "jobq", offsetof(struct sim_config, jobq), jobq_kind, jobq_name },
+	{ "rng", offsetof(struct sim_config, rng), rng_kind, rng_name },
+	{ "kernel", offsetof(struct sim_config, kernel), kernel_kind, kernel_name },
+	{ NULL, 0, NULL, NULL }
+};
+
+/* The simulation loop, one iteration per event, until events have
+ * been run or the tick until reached; returns SIM_RUNNING, SIM_DONE,
+ * or -1 with errno set. It is written out once for every policy, so
+ * that run_send() and schedule() are fixed at compile time and cost
+ * no dispatch per tick. */
+#define SIMULATE(name, POLICY, RUN_SEND, SCHEDULE) \
+static int name(struct simulation *sim, long int events, long int until) \
+{ \
+	long int ticks; \
+\
+	for (;(events > 0)&&(sim->now < until)&&!(sim->error);--events) { \
+		if ( (sim->done)||(sim->stop_requested) ) return SIM_DONE; \
+		++sim->now; \
+		if (sim->report_requested) report(sim); \
+		traceall(sim); \
+		if (sim->error) break; \
+		/* if MAX_JOBS are complete, stop */ \
+		if (sim->jobs_done >= MAX_JOBS) { \
+			sim->done = 1; \
+			return SIM_DONE; \
+		} \
+		add_remove(sim); \
+		RUN_SEND(sim); \
+		SCHEDULE(sim); \
+		ticks = skip_quiet_ticks(sim,POLICY,until - sim->now); \
+		if (sim->error) break; \
+		if (INTERVAL) /*wait INTERVAL seconds per tick*/ \
+			sleep(INTERVAL*(ticks + 1)); \
+	} \
+	if (sim->error) { \
+		errno = sim->error; \
+		return -1; \
+	} \
+	return ( (sim->done)||(sim->stop_requested) ) ? SIM_DONE : SIM_RUNNING; \
+}
+
+SIMULATE(simulate_fcfs, FCFS, run_send, schedule_fcfs)
+SIMULATE(simulate_lwf, LWF, run_send, schedule_lwf)
+SIMULATE(simulate_mixed, MIXED, run_send, schedule_mixed)
+SIMULATE(simulate_ar, AR, run_send_ar, schedule_ar)
+
+static struct policy policy_table[] = {
+	{ "fcfs", FCFS, simulate_fcfs },
+	{ "lwf", LWF, simulate_lwf },
+	{ "mixed", MIXED, simulate_mixed },
+	{ "ar", AR, simulate_ar },
+	{ NULL, 0, NULL }
+};
+
+void sim_defaults(struct sim_config *c)
+{
+	*c = default_config;
+}
+
+int sim_policy(const char *name)
+{
+	struct policy *p;
+
+	for (p=policy_table;p->name;++p)
+		if (!strcmp(p->name,name)) return p->kind;
+	return 0;
+}
+
+const char *sim_policy_name(int policy)
+{
+	struct policy *p;
+
+	for (p=policy_table;p->name;++p)
+		if (p->kind == policy) return p->name;
+	return "?";
+}
+
+/* a simulation of a checked configuration at tick 0; returns NULL with
+ * errno set if it cannot be made */
+struct simulation *sim_create(struct sim_config *c)
+{
+	struct simulation *sim;
+	struct policy *p;
+
+	for (p=policy_table;p->name&&(p->kind != c->policy);++p);
+	if ( !(p->name)||!fel_name(c->fel)||!jobq_name(c->jobq)||!rng_name(c->rng)
+	    ||(c->kernel&&!kernel_supported(c->kernel))||sim_check(c) ) {
+		errno = EINVAL;
+		return NULL;
+	}
+	if ( !(sim = malloc(sizeof(struct simulation))) ) {
+		errno = ENOMEM;
+		return NULL;
+	}
+	memset(sim, 0, sizeof(struct simulation));
+	sim->config = *c;
+	if (!c->kernel) sim->config.kernel = kernel_best();
+	sim->policy = p;
+	sim->out.sink.fd = -1;
+	if (reset(sim)) {
+		sim_destroy(sim);
+		errno = ENOMEM;
+		return NULL;
+	}
+	return sim;
+}
+
+/* write out what is recorded and free the simulation; returns 0 on
+ * success, -1 with errno set if the statistics could not be written */
+int sim_destroy(struct simulation *sim)
+{
+	int err = stats_close(&sim->out) ? errno : 0;
+
+	fel_free(&sim->events);
+	jobq_free(&sim->ranked);
+	free(sim->jobs.code);
+	free(sim->jobs.state);
+	free(sim->jobs.workload);
+	free(sim->jobs.send_data);
+	free(sim->jobs.wait_time);
+	free(sim->jobs.wait_since);
+	free(sim->jobs.run_on);
+	free(sim->jobs.next_rsv);
+	free(sim->jobs.next_waiting);
+	free(sim->jobs.prev_waiting);
+	free(sim->jobs.node);
+	free(sim->res.code);
+	free(sim->res.state);
+	free(sim->res.level);
+	free(sim->res.added);
+	free(sim->res.used_time);
+	free(sim->res.job);
+	free(sim->res.total_workload);
+	free(sim->res.first_rsv);
+	free(sim->res.last_rsv);
+	free(sim->res.next_free);
+	free(sim->res.prev_free);
+	free(sim->res.load_pos);
+	free(sim->sent.index);
+	free(sim->finished.index);
+	free(sim->done_jobs.index);
+	free(sim->leaving.index);
+	free(sim->load.index);
+	free(sim);
+	if (!err) return 0;
+	errno = err;
+	return -1;
+}
+
+/* run up to events iterations of the simulation loop, each a tick
+ * something happens at, the quiet ticks between them skipped */
+int sim_step(struct simulation *sim, long int events)
+{
+	return sim->policy->simulate(sim,events,LONG_MAX);
+}
+
+/* run the simulation up to ticks ticks further, stopping the skipping
+ * of quiet ticks there; stepped by ticks or events, a simulation goes
+ * the same way as run to its end at once */
+int sim_step_ticks(struct simulation *sim, long int ticks)
+{
+	return sim->policy->simulate(sim,LONG_MAX,(ticks < LONG_MAX - sim->now) ? sim->now + ticks : LONG_MAX);
+}
+
+int sim_run(struct simulation *sim)
+{
+	int ret;
+
+	while ( (ret = sim_step(sim,LONG_MAX)) == SIM_RUNNING );
+	return ret;
+}
+
+void sim_stats(struct simulation *sim, struct sim_stats *st)
+{
+	st->now = sim->now;
+	st->jobs_done = sim->jobs_done;
+	st->job_number = sim->job_number;
+	st->resource_number = sim->resource_number;
+	st->jobs = sim->jobs.n - sim->jobs_in[DONE];
+	st->jobs_waiting = sim->jobs_in[WAITING] + sim->jobs_in[WAITING_TO_SEND_DATA] + sim->jobs_in[READY_TO_RUN];
+	st->resources = sim->res.n - sim->res_in[LEAVING];
+	st->resources_gone = sim->resources_gone;
+	st->mean_usage = sim->mean_usage;
+	st->mean_wait_time = wait_mean(sim);
+}
+
+/* record is called with arg and the statistics every record_interval
+ * jobs done, as they are written to the output */
+void sim_on_record(struct simulation *sim, void (*record)(void *, struct sim_stats *), void *arg)
+{
+	sim->record = record;
+	sim->record_arg = arg;
+}
+
+/* these two only set a flag, so that signal handlers may call them:
+ * the simulation stops, or writes the jobs and resources in each state
+ * to stderr, at its next tick */
+void sim_stop(struct simulation *sim)
+{
+	sim->stop_requested = 1;
+}
+
+void sim_request_report(struct simulation *sim)
+{
+	sim->report_requested = 1;
+}
+
+/* start from tick 0 and the seed */
+static int reset(struct simulation *sim)
+{
+	int ranking = sim->config.jobq;
+	long int r;
+
+	sim->waiting.first = sim->waiting.last = -1;
+	sim->free_res.first = sim->free_res.last = -1;
+	for (r=0;r<STREAMS;++r) {
+		rng_seed(&sim->rng[r], sim->config.rng, sim->config.seed, r);
+		sim->stream[r] = (sim->config.rng == RNG_LEGACY) ? &sim->rng[0] : &sim->rng[r];
+	}
+
+	if (fel_init(&sim->events,sim->config.fel)) return -1;
+	/* LWF keys are workloads, 50..999; mixed keys grow with the
+	 * ticks, beyond the reach of a bucket queue */
+	if (sim->policy->kind == MIXED) {
+		if (ranking == JOBQ_BUCKET) ranking = JOBQ_HEAP;
+		return jobq_init(&sim->ranked,ranking,LONG_MIN,LONG_MAX);
+	}
+	return jobq_init(&sim->ranked,ranking,50,999);
+}
+
+static void add_remove(struct simulation *sim)
+{
+	int i;
+
+	if (sim->now == 1)
+		for (i=1;i<=5;++i) add_res(sim);
+
+	remove_done_jobs(sim);
+
+	remove_leaving_resources(sim);
+
+	if (sim->next_roll) {
+		i = sim->next_roll;
+		sim->next_roll = 0;
+	} else i = 1 + ROLL(ARRIVAL,1000);
+	if ( i <= ADD_RESOURCE_PROB )
+		add_res(sim);
+	else if ( i > ADD_JOB_PROB )
+		add_job(sim);
+}
+
+/* The lists of the older simulators kept jobs and resources in order
+ * of arrival, and the policies pick the first of equals; the waiting
+ * queue and the free resource list keep that order. */
+
+static void schedule_fcfs(struct simulation *sim) /*simple FCFS scheduling*/
+{
+	long int j, r;
+
+	/* if no job or no available resource exists, return */
+	if ( !(sim->jobs_in[WAITING])||!(sim->res_in[AVAILABLE]) ) return;
+
+	/* select first waiting job and first available resource */
+	j = sim->waiting.first;
+	r = sim->free_res.first;
+
+	/* match job with resource */
+	queue_remove(&sim->waiting,sim->jobs.next_waiting,sim->jobs.prev_waiting,j);
+	queue_remove(&sim->free_res,sim->res.next_free,sim->res.prev_free,r);
+	sim->jobs.run_on[j] = r;
+	set_job_state(sim,j,SENDING_DATA);
+	set_res_state(sim,r,RECEIVING_DATA);
+	sim->res.job[r] = j;
+	add_event(sim,sim->now + ((sim->jobs.send_data[j] > 1) ? sim->jobs.send_data[j] : 1),NULL);
+}
+
+static void schedule_lwf(struct simulation *sim) /*simple LWF scheduling*/
+{
+	long int best_job, r;
+
+	/* if no job or no available resource exists, return */
+	if ( !(sim->jobs_in[WAITING])||!(sim->res_in[AVAILABLE]) ) return;
+
+	/* select first available resource */
+	r = sim->free_res.first;
+
+	/* select job with least workload */
+	best_job = jobq_pop(&sim->ranked);
+
+	/* match job with resource */
+	sim->jobs.node[best_job] = -1;
+	queue_remove(&sim->waiting,sim->jobs.next_waiting,sim->jobs.prev_waiting,best_job);
+	queue_remove(&sim->free_res,sim->res.next_free,sim->res.prev_free,r);
+	sim->jobs.run_on[best_job] = r;
+	set_job_state(sim,best_job,SENDING_DATA);
+	set_res_state(sim,r,RECEIVING_DATA);
+	sim->res.job[r] = best_job;
+	add_event(sim,sim->now + ((sim->jobs.send_data[best_job] > 1) ? sim->jobs.send_data[best_job] : 1),NULL);
+}
+
+/* A waiting job scores FCFS_W*wait_time + LWF_W*workload, and its
+ * wait_time is now less the tick it arrived at, the same for all of
+ * them. The best job is then the first in the ranked queue, keyed on
+ * FCFS_W*arrival - LWF_W*workload when it arrives, the first of equal
+ * scores to arrive. */
+static void schedule_mixed(struct simulation *sim) /* mixed scheduling */
+{
+	long int best_job, r;
+
+	/* if no job or no available resource exists, return */
+	if ( !(sim->jobs_in[WAITING])||!(sim->res_in[AVAILABLE]) ) return;
+
+	/* select first available resource */
+	r = sim->free_res.first;
+
+	/* select best job */
+	best_job = jobq_pop(&sim->ranked);
+
+	/* match job with resource */
+	sim->jobs.node[best_job] = -1;
+	queue_remove(&sim->waiting,sim->jobs.next_waiting,sim->jobs.prev_waiting,best_job);
+	queue_remove(&sim->free_res,sim->res.next_free,sim->res.prev_free,r);
+	sim->jobs.run_on[best_job] = r;
+	set_job_state(sim,best_job,SENDING_DATA);
+	set_res_state(sim,r,RECEIVING_DATA);
+	sim->res.job[r] = best_job;
+	add_event(sim,sim->now + ((sim->jobs.send_data[best_job] > 1) ? sim->jobs.send_data[best_job] : 1),NULL);
+}
+
+static void schedule_ar(struct simulation *sim) /*AR scheduling*/
+{
+	long int best_job, best_r;
+
+	/* if no job or no resource accepting jobs exists, return */
+	if ( !(sim->jobs_in[WAITING])||!(sim->load.n) ) return;
+
+	/* begin with the first waiting job */
+	best_job = sim->waiting.first;
+
+	/* select best resource */
+	best_r = sim->load.index[0];
+
+	/* match job with resource */
+	queue_remove(&sim->waiting,sim->jobs.next_waiting,sim->jobs.prev_waiting,best_job);
+	set_job_state(sim,best_job,WAITING_TO_SEND_DATA);
+	sim->jobs.run_on[best_job] = best_r;
+	if (sim->res.state[best_r] == AVAILABLE) queue_remove(&sim->free_res,sim->res.next_free,sim->res.prev_free,best_r);
+	set_res_state(sim,best_r,HAS_JOBS);
+	sim->res.total_workload[best_r] += sim->jobs.workload[best_job];
+	load_update(sim,best_r);
+	sim->jobs.next_rsv[best_job] = -1;
+	sim->pending = 1;
+	if (sim->res.first_rsv[best_r] >= 0) {
+		sim->jobs.next_rsv[sim->res.last_rsv[best_r]] = best_job;
+		sim->res.last_rsv[best_r] = best_job;
+	} else {
+		sim->res.first_rsv[best_r] = best_job;
+		sim->res.last_rsv[best_r] = best_job;
+	}
+}
+
+/* set a parameter of config, or a backend by its name (fel calendar,
+ * rng legacy), from a "name=value" or "name value" setting, where is
+ * where it comes from for error messages; returns -1 if invalid */
+int sim_set(struct sim_config *config, char *setting, char *where)
+{
+	const struct parameter *p;
+	const struct backend *b;
+	char *value, *end, name[32];
+	size_t len;
+	long int v;
+	int kind;
+
+	len = strcspn(setting," \t=");
+	value = setting + len + strspn(setting + len," \t=");
+	for (p=parameter_table;p->name;++p)
+		if ( (strlen(p->name) == len)&&!strncmp(p->name,setting,len) ) break;
+	for (b=backend_table;!(p->name)&&b->name;++b)
+		if ( (strlen(b->name) == len)&&!strncmp(b->name,setting,len) ) break;
+	if ( !(p->name)&&!(b->name) ) {
+		fprintf(stderr,"%s: unknown parameter %.*s\n",where,(int)len,setting);
+		return -1;
+	}
+	if (!(p->name)) {
+		len = strcspn(value," \t\r\n");
+		snprintf(name,sizeof(name),"%.*s",(int)len,value);
+		if ( !(kind = b->kind(name))||value[len + strspn(value + len," \t\r\n")] ) {
+			fprintf(stderr,"%s: unknown %s %.*s\n",where,b->name,(int)strcspn(value,"\r\n"),value);
+			return -1;
+		}
+		BACKEND(config,b) = kind;
+		return 0;
+	}
+	errno = 0;
+	v = strtol(value,&end,10);
+	end += strspn(end," \t\r\n");
+	if ( errno||(end == value)||*end||(v < p->min)||(v > p->max) ) {
+		fprintf(stderr,"%s: %s must be an integer from %li to %li\n",where,p->name,p->min,p->max);
+		return -1;
+	}
+	PARAMETER(config,p) = v;
+	return 0;
+}
+
+/* read parameters from a file, a setting per line, # starting a
+ * comment; returns -1 if it cannot be read or has invalid settings */
+int sim_read_config(struct sim_config *config, char *path)
+{
+	char line[256], where[PATH_MAX + 32];
+	char *s;
+	FILE *fp;
+	int n = 0, err = 0;
+
+	if ( !(fp = fopen(path,"r")) ) {
+		perror(path);
+		return -1;
+	}
+	while (fgets(line,sizeof(line),fp)) {
+		++n;
+		if ( (s = strchr(line,'#')) ) *s = 0;
+		s = line + strspn(line," \t\r\n");
+		if (!*s) continue;
+		snprintf(where,sizeof(where),"%s:%i",path,n);
+		if (sim_set(config,s,where)) err = -1;
+	}
+	fclose(fp);
+	return err;
+}
+
+/* write every parameter and backend, a setting per line, as
+ * sim_read_config() reads them; the kernel only if one was chosen;
+ * returns -1 with errno set on failure */
+int sim_write_config(struct sim_config *config, FILE *fp)
+{
+	const struct parameter *p;
+	const struct backend *b;
+
+	for (p=parameter_table;p->name;++p)
+		fprintf(fp,"%s %li\n",p->name,PARAMETER(config,p));
+	for (b=backend_table;b->name;++b)
+		if (BACKEND(config,b)) fprintf(fp,"%s %s\n",b->name,b->kind_name(BACKEND(config,b)));
+	return ferror(fp) ? -1 : 0;
+}
+
+/* the parameters must agree with each other and, in a FIXED_CONFIG
+ * build, with the values built in; returns -1 if they do not */
+int sim_check(struct sim_config *config)
+{
+	const struct parameter *p;
+
+	if (config->add_resource_prob > config->add_job_prob) {
+		fprintf(stderr,"add_resource_prob must not be above add_job_prob\n");
+		return -1;
+	}
+#ifdef FIXED_CONFIG
+	for (p=parameter_table;p->name;++p)
+		if ( (p->fixed)&&(PARAMETER(config,p) != p->built_in) ) {
+			fprintf(stderr,"%s is fixed at %li in this build\n",p->name,p->built_in);
+			return -1;
+		}
+#else
+	(void)p;
+#endif
+	return 0;
+}
+
+/* open a statistics file for the simulation to write its records to,
+ * the binary header recording its configuration; returns 0 on success,
+ * -1 with errno set on failure */
+int sim_output(struct simulation *sim, const char *path, int format, int flags)
+{
+	struct stats_header h;
+
+	stats_close(&sim->out);
+	memset(&h, 0, sizeof(h));
+	strncpy(h.policy, sim->policy->name, sizeof(h.policy) - 1);
+	h.seed = sim->config.seed;
+	h.interval = INTERVAL;
+	h.max_jobs = MAX_JOBS;
+	h.record_interval = RECORD_INTERVAL;
+	h.rl_prob = RL_PROB;
+	h.add_resource_prob = ADD_RESOURCE_PROB;
+	h.add_job_prob = ADD_JOB_PROB;
+	h.fcfs_w = FCFS_W;
+	h.lwf_w = LWF_W;
+	h.fel = sim->config.fel;
+	h.jobq = sim->config.jobq;
+	h.rng = sim->config.rng;
+	return stats_open(&sim->out,path,format,flags,&h);
+}
+
+static void add_res(struct simulation *sim)
+{
+	long int r, max;
+
+	if (sim->res.n == sim->res.max) {
+		max = sim->res.max ? 2*sim->res.max : SLAB;
+		if ( grow(&sim->res.code,max,sizeof(long int))||grow(&sim->res.state,max,sizeof(uint8_t))
+		    ||grow(&sim->res.level,max,sizeof(int))||grow(&sim->res.added,max,sizeof(long int))
+		    ||grow(&sim->res.used_time,max,sizeof(float))||grow(&sim->res.job,max,sizeof(int32_t))
+		    ||grow(&sim->res.total_workload,max,sizeof(long int))
+		    ||grow(&sim->res.first_rsv,max,sizeof(int32_t))||grow(&sim->res.last_rsv,max,sizeof(int32_t))
+		    ||grow(&sim->res.next_free,max,sizeof(int32_t))||grow(&sim->res.prev_free,max,sizeof(int32_t))
+		    ||grow(&sim->res.load_pos,max,sizeof(int32_t)) ) {
+			sim->error = ENOMEM;
+			return;
+		}
+		sim->res.max = max;
+	}
+	r = sim->res.n++;
+	sim->res.code[r] = ++sim->resource_number;
+	sim->res.state[r] = AVAILABLE;
+	++sim->res_in[AVAILABLE];
+	sim->res.level[r] = 1 + ROLL(LEVEL,5);
+	sim->res.added[r] = sim->now;
+	sim->res.used_time[r] = 0;
+	sim->res.job[r] = -1;
+	sim->res.total_workload[r] = 0;
+	sim->res.first_rsv[r] = -1;
+	sim->res.last_rsv[r] = -1;
+	queue_append(&sim->free_res,sim->res.next_free,sim->res.prev_free,r);
+	sim->res.load_pos[r] = -1;
+	if (sim->policy->kind == AR) load_insert(sim,r);
+}
+
+static void add_job(struct simulation *sim)
+{
+	long int j, max;
+
+	if (sim->jobs.n == sim->jobs.max) {
+		max = sim->jobs.max ? 2*sim->jobs.max : SLAB;
+		if ( grow(&sim->jobs.code,max,sizeof(long int))||grow(&sim->jobs.state,max,sizeof(uint8_t))
+		    ||grow(&sim->jobs.workload,max,sizeof(int))||grow(&sim->jobs.send_data,max,sizeof(int))
+		    ||grow(&sim->jobs.wait_time,max,sizeof(long int))||grow(&sim->jobs.wait_since,max,sizeof(long int))
+		    ||grow(&sim->jobs.run_on,max,sizeof(int32_t))
+		    ||grow(&sim->jobs.next_rsv,max,sizeof(int32_t))
+		    ||grow(&sim->jobs.next_waiting,max,sizeof(int32_t))||grow(&sim->jobs.prev_waiting,max,sizeof(int32_t))
+		    ||grow(&sim->jobs.node,max,sizeof(int32_t)) ) {
+			sim->error = ENOMEM;
+			return;
+		}
+		sim->jobs.max = max;
+	}
+	j = sim->jobs.n++;
+	sim->jobs.code[j] = ++sim->job_number;
+	sim->jobs.state[j] = WAITING;
+	++sim->jobs_in[WAITING];
+	sim->jobs.workload[j] = 50 + ROLL(WORKLOAD,950);
+	sim->jobs.wait_time[j] = 0;
+	sim->jobs.wait_since[j] = sim->now;
+	sim->since_sum += sim->now;
+	sim->jobs.run_on[j] = -1;
+	sim->jobs.next_rsv[j] = -1;
+	sim->jobs.send_data[j] = ROLL(SEND_DATA,30);
+	queue_append(&sim->waiting,sim->jobs.next_waiting,sim->jobs.prev_waiting,j);
+	sim->jobs.node[j] = -1;
+	if ( (sim->policy->kind == LWF)
+	    &&((sim->jobs.node[j] = jobq_insert(&sim->ranked,sim->jobs.workload[j],sim->jobs.code[j],j)) < 0) ) sim->error = ENOMEM;
+	if ( (sim->policy->kind == MIXED)
+	    &&((sim->jobs.node[j] = jobq_insert(&sim->ranked,FCFS_W*sim->now - LWF_W*sim->jobs.workload[j],sim->jobs.code[j],j)) < 0) ) sim->error = ENOMEM;
+}
+
+/* resize a table column to max entries, returns -1 if out of memory
+ * or beyond the reach of a 32 bit index */
+static int grow(void *column, long int max, size_t size)
+{
+	void *p;
+
+	if ( (max > INT32_MAX)||!(p = realloc(*(void **)column, max*size)) ) return -1;
+	*(void **)column = p;
+	return 0;
+}
+
+/* remove job j, moving the last job into its place */
+static void remove_job(struct simulation *sim, long int j)
+{
+	long int last = --sim->jobs.n;
+	long int r;
+
+	--sim->jobs_in[sim->jobs.state[j]];
+	sim->wait_sum -= sim->jobs.wait_time[j];
+	if (IS_WAITING(sim->jobs.state[j])) sim->since_sum -= sim->jobs.wait_since[j];
+	if ( ((r = sim->jobs.run_on[j]) >= 0)&&(sim->res.job[r] == j) ) sim->res.job[r] = -1;
+	if (j == last) return;
+
+	sim->jobs.code[j] = sim->jobs.code[last];
+	sim->jobs.state[j] = sim->jobs.state[last];
+	sim->jobs.workload[j] = sim->jobs.workload[last];
+	sim->jobs.send_data[j] = sim->jobs.send_data[last];
+	sim->jobs.wait_time[j] = sim->jobs.wait_time[last];
+	sim->jobs.wait_since[j] = sim->jobs.wait_since[last];
+	sim->jobs.run_on[j] = sim->jobs.run_on[last];
+	sim->jobs.next_rsv[j] = sim->jobs.next_rsv[last];
+	sim->jobs.next_waiting[j] = sim->jobs.next_waiting[last];
+	sim->jobs.prev_waiting[j] = sim->jobs.prev_waiting[last];
+	sim->jobs.node[j] = sim->jobs.node[last];
+	if ( ((r = sim->jobs.run_on[j]) >= 0)&&(sim->res.job[r] == last) ) sim->res.job[r] = j;
+	if ( (sim->policy->kind == AR)&&(sim->jobs.run_on[j] >= 0)&&(sim->jobs.state[j] != DONE) ) rsv_moved(sim,last,j);
+	if (sim->jobs.state[j] == WAITING) queue_moved(&sim->waiting,sim->jobs.next_waiting,sim->jobs.prev_waiting,j);
+	if (sim->jobs.node[j] >= 0) jobq_moved(&sim->ranked,sim->jobs.node[j],j);
+}
+
+/* remove resource r, moving the last resource into its place */
+static void remove_res(struct simulation *sim, long int r)
+{
+	long int last = --sim->res.n;
+	long int j;
+
+	--sim->res_in[sim->res.state[r]];
+	load_remove(sim,r);
+	if (r == last) return;
+
+	sim->res.code[r] = sim->res.code[last];
+	sim->res.state[r] = sim->res.state[last];
+	sim->res.level[r] = sim->res.level[last];
+	sim->res.added[r] = sim->res.added[last];
+	sim->res.used_time[r] = sim->res.used_time[last];
+	sim->res.job[r] = sim->res.job[last];
+	sim->res.total_workload[r] = sim->res.total_workload[last];
+	sim->res.first_rsv[r] = sim->res.first_rsv[last];
+	sim->res.last_rsv[r] = sim->res.last_rsv[last];
+	sim->res.next_free[r] = sim->res.next_free[last];
+	sim->res.prev_free[r] = sim->res.prev_free[last];
+	sim->res.load_pos[r] = sim->res.load_pos[last];
+	if (sim->res.job[r] >= 0) sim->jobs.run_on[sim->res.job[r]] = r;
+	if (sim->res.state[r] == AVAILABLE) queue_moved(&sim->free_res,sim->res.next_free,sim->res.prev_free,r);
+	if (sim->res.load_pos[r] >= 0) sim->load.index[sim->res.load_pos[r]] = r;
+	for (j=sim->res.first_rsv[r];j >= 0;j=sim->jobs.next_rsv[j]) sim->jobs.run_on[j] = r;
+}
+
+/* Jobs and resources are listed as they are set DONE and LEAVING, and
+ * removed from the lists, so that removing them costs nothing more for
+ * the others in the tables. The highest index goes first: the last
+ * entry, moved into its place, is then never one still to remove. */
+
+static void remove_done_jobs(struct simulation *sim)
+{
+	long int i;
+
+	sort_by_index(&sim->done_jobs);
+	for (i=0;i<sim->done_jobs.n;++i)
+		remove_job(sim,sim->done_jobs.index[i]);
+	sim->done_jobs.n = 0;
+}
+
+/* the resources traceall() counted */
+static void remove_leaving_resources(struct simulation *sim)
+{
+	long int i;
+
+	sort_by_index(&sim->leaving);
+	for (i=0;i<sim->leaving.n;++i)
+		remove_res(sim,sim->leaving.index[i]);
+	sim->leaving.n = 0;
+}
+
+static void run_send(struct simulation *sim) /* FCFS, LWF and mixed: a job at a time per resource */
+{
+	long int i, j, r, d;
+
+	sim->sent.n = 0;
+	sim->finished.n = 0;
+	if ( !(sim->jobs_in[SENDING_DATA])&&!(sim->jobs_in[RUNNING]) ) return;
+	if (run_kernel(sim,1L)) return;
+
+	/* jobs done sending run, their resources counted used for all the
+	 * ticks the run takes */
+	for (i=0;i<sim->sent.n;++i) {
+		j = sim->sent.index[i];
+		r = sim->jobs.run_on[j];
+		d = (sim->jobs.workload[j] + sim->res.level[r] - 1)/sim->res.level[r];
+		set_job_state(sim,j,RUNNING);
+		set_res_state(sim,r,USED);
+		sim->res.used_time[r] += d;
+		add_event(sim,sim->now + d,NULL);
+	}
+	for (i=0;i<sim->finished.n;++i) {
+		j = sim->finished.index[i];
+		set_job_state(sim,j,DONE);
+		set_res_state(sim,sim->jobs.run_on[j],AVAILABLE);
+		sim->pending = 1;
+	}
+
+	/* resources of ended jobs may leave, in order of job arrival,
+	 * the others are free again */
+	sort_by_code(&sim->finished,sim->jobs.code);
+	for (i=0;i<sim->finished.n;++i) {
+		r = sim->jobs.run_on[sim->finished.index[i]];
+		if ( ROLL(DEPARTURE,1000) <= RL_PROB ) set_res_state(sim,r,LEAVING);
+		else queue_insert(&sim->free_res,sim->res.next_free,sim->res.prev_free,r,sim->res.code);
+	}
+}
+
+static void run_send_ar(struct simulation *sim) /* AR: run the first reservation, send data to the next */
+{
+	long int i, j, r;
+
+	sim->finished.n = 0;
+	if ( !(sim->jobs_in[WAITING_TO_SEND_DATA])&&!(sim->jobs_in[SENDING_DATA])&&!(sim->jobs_in[READY_TO_RUN])
+	    &&!(sim->jobs_in[RUNNING])&&!(sim->res_in[NO_ACCEPT_JOBS]) ) return;
+	for (r=0;r<sim->res.n;++r) {
+		if ( (sim->res.state[r]==NO_ACCEPT_JOBS)&&(sim->res.first_rsv[r] < 0) ) {
+			set_res_state(sim,r,LEAVING);
+			load_insert(sim,r);
+			sim->pending = 1;
+			continue;
+		}
+
+		/* run job: */
+		if ( (j = sim->res.first_rsv[r]) < 0 ) continue;
+		switch (sim->jobs.state[j]) {
+		case RUNNING:
+			sim->jobs.workload[j] -= sim->res.level[r];
+			sim->res.total_workload[r] -= sim->res.level[r];
+			load_update(sim,r);
+			sim->res.used_time[r]++;
+			if (sim->jobs.workload[j] < 0) {
+				set_job_state(sim,j,DONE);
+				if ( (sim->res.first_rsv[r] = sim->jobs.next_rsv[j]) < 0 ) sim->res.last_rsv[r] = -1;
+				sim->pending = 1;
+				add_index(sim,&sim->finished,r);
+			}
+			break;
+		case READY_TO_RUN:
+			set_job_state(sim,j,RUNNING);
+			add_event(sim,sim->now + sim->jobs.workload[j]/sim->res.level[r] + 1,NULL);
+			break;
+		default:
+			break;
+		}
+
+		/* send input data: */
+		for (j=sim->res.first_rsv[r];j >= 0;j=sim->jobs.next_rsv[j]) {
+			if (sim->jobs.state[j] == SENDING_DATA) {
+				sim->jobs.send_data[j]--;
+				if (sim->jobs.send_data[j] <= 0) {
+					set_job_state(sim,j,READY_TO_RUN);
+					sim->pending = 1;
+					if (sim->jobs.next_rsv[j] >= 0) {
+						j = sim->jobs.next_rsv[j];
+						set_job_state(sim,j,SENDING_DATA);
+						add_event(sim,sim->now + ((sim->jobs.send_data[j] > 1) ? sim->jobs.send_data[j] : 1),NULL);
+					}
+				}
+				break;
+			} else if (sim->jobs.state[j] == WAITING_TO_SEND_DATA) {
+				set_job_state(sim,j,SENDING_DATA);
+				add_event(sim,sim->now + ((sim->jobs.send_data[j] > 1) ? sim->jobs.send_data[j] : 1),NULL);
+				break;
+			}
+		}
+	}
+
+	/* resources that ended a job may stop accepting jobs, in order of arrival */
+	sort_by_code(&sim->finished,sim->res.code);
+	for (i=0;i<sim->finished.n;++i)
+		if ( ROLL(DEPARTURE,1000) <= RL_PROB ) {
+			r = sim->finished.index[i];
+			set_res_state(sim,r,NO_ACCEPT_JOBS);
+			load_remove(sim,r);
+		}
+}
+
+/* The statistics change only as jobs end and resources leave, so
+ * traceall() takes them from the lists run_send() fills, the jobs done
+ * and resources leaving last tick, and costs as much as they are many.
+ * The total time of a resource, the ticks counted up to now since the
+ * one it was added at, is worked out as it leaves. */
+static void traceall(struct simulation *sim)
+{
+	float temp;
+	long int done = sim->done_jobs.n;
+	long int i, k, r;
+
+	/* every RECORD_INTERVAL done jobs, save mean usage and wait time */
+	while (done--)
+		if (!(++sim->jobs_done%RECORD_INTERVAL)) record_mean_usage(sim);
+
+	/* AR may have given a leaving resource a job since */
+	for (i=k=0;i<sim->leaving.n;++i)
+		if (sim->res.state[sim->leaving.index[i]] == LEAVING) sim->leaving.index[k++] = sim->leaving.index[i];
+	sim->leaving.n = k;
+
+	/* in order of arrival, as the float mean depends on it */
+	sort_by_code(&sim->leaving,sim->res.code);
+	for (i=0;i<sim->leaving.n;++i) {
+		r = sim->leaving.index[i];
+		temp = (sim->res.used_time[r]/(float)(sim->now - sim->res.added[r]))*100;
+		sim->mean_usage = (sim->mean_usage*sim->resources_gone + temp)/(sim->resources_gone + 1);
+		++sim->resources_gone;
+	}
+}
+
+/* A job has waited wait_time ticks, and if it is waiting, now less
+ * wait_since more: the ticks from the one after it began waiting up
+ * to the current one. The mean over all jobs comes from the sums. */
+static void record_mean_usage(struct simulation *sim)
+{
+	struct sim_stats st;
+
+	sim->mean_wait_time = wait_mean(sim);
+	if ( (sim->out.sink.fd >= 0)&&!(sim->error)&&stats_record(&sim->out,sim->jobs_done,sim->mean_usage,sim->mean_wait_time,sim->job_number) )
+		sim->error = errno;
+	if (sim->record) {
+		sim_stats(sim,&st);
+		sim->record(sim->record_arg,&st);
+	}
+}
+
+static double wait_mean(struct simulation *sim)
+{
+	long int waiting_jobs = sim->jobs_in[WAITING] + sim->jobs_in[WAITING_TO_SEND_DATA] + sim->jobs_in[READY_TO_RUN];
+
+	if (!(sim->jobs.n)) return 0;
+	return (double)(sim->wait_sum + waiting_jobs*sim->now - sim->since_sum)/sim->jobs.n;
+}
+
+/* schedule the end of a transfer or a run */
+static void add_event(struct simulation *sim, long int time, void *data)
+{
+	if (fel_insert(&sim->events,time,data)) sim->error = ENOMEM;
+}
+
+static void add_index(struct simulation *sim, struct index_list *l, long int i)
+{
+	int32_t *p;
+
+	if (l->n == l->max) {
+		if ( !(p = realloc(l->index, (l->max ? 2*l->max : SLAB)*sizeof(int32_t))) ) {
+			sim->error = ENOMEM;
+			return;
+		}
+		l->index = p;
+		l->max = l->max ? 2*l->max : SLAB;
+	}
+	l->index[l->n++] = i;
+}
+
+/* room for n indexes in l; returns -1 if there is not */
+static int fit_index(struct index_list *l, long int n)
+{
+	if (n <= l->max) return 0;
+	if (grow(&l->index,n,sizeof(int32_t))) return -1;
+	l->max = n;
+	return 0;
+}
+
+/* advance the sending and running jobs by d ticks with the job kernel
+ * of the configuration, listing in sent and finished those whose
+ * transfer or run ends; returns -1 if the lists have no room */
+static int run_kernel(struct simulation *sim, long int d)
+{
+	struct kernel_jobs t;
+
+	if ( fit_index(&sim->sent,sim->jobs.max)||fit_index(&sim->finished,sim->jobs.max) ) {
+		sim->error = ENOMEM;
+		return -1;
+	}
+	t.n = sim->jobs.n;
+	t.state = sim->jobs.state;
+	t.workload = sim->jobs.workload;
+	t.send_data = sim->jobs.send_data;
+	t.run_on = sim->jobs.run_on;
+	t.level = sim->res.level;
+	t.sending = SENDING_DATA;
+	t.running = RUNNING;
+	kernel_advance(sim->config.kernel,&t,d,sim->sent.index,&sim->sent.n,sim->finished.index,&sim->finished.n);
+	return 0;
+}
+
+/* insertion sort, the lists are a few entries long */
+static void sort_by_code(struct index_list *l, long int *code)
+{
+	long int i, k, x;
+
+	for (i=1;i<l->n;++i) {
+		x = l->index[i];
+		for (k=i;(k > 0)&&(code[l->index[k-1]] > code[x]);--k)
+			l->index[k] = l->index[k-1];
+		l->index[k] = x;
+	}
+}
+
+/* highest index first, the lists are a few entries long */
+static void sort_by_index(struct index_list *l)
+{
+	long int i, k, x;
+
+	for (i=1;i<l->n;++i) {
+		x = l->index[i];
+		for (k=i;(k > 0)&&(l->index[k-1] < x);--k)
+			l->index[k] = l->index[k-1];
+		l->index[k] = x;
+	}
+}
+
+/* every state change goes through these, to keep the counts, the
+ * lists of entries to remove and, for jobs, the time they wait */
+static void set_job_state(struct simulation *sim, long int j, int state)
+{
+	if ( IS_WAITING(sim->jobs.state[j]) && !IS_WAITING(state) ) {
+		sim->jobs.wait_time[j] += sim->now - sim->jobs.wait_since[j];
+		sim->wait_sum += sim->now - sim->jobs.wait_since[j];
+		sim->since_sum -= sim->jobs.wait_since[j];
+	} else if ( !IS_WAITING(sim->jobs.state[j]) && IS_WAITING(state) ) {
+		sim->jobs.wait_since[j] = sim->now;
+		sim->since_sum += sim->now;
+	}
+	--sim->jobs_in[sim->jobs.state[j]];
+	++sim->jobs_in[state];
+	sim->jobs.state[j] = state;
+	if (state == DONE) add_index(sim,&sim->done_jobs,j);
+}
+
+
+static void set_res_state(struct simulation *sim, long int r, int state)
+{
+	--sim->res_in[sim->res.state[r]];
+	++sim->res_in[state];
+	sim->res.state[r] = state;
+	if (state == LEAVING) add_index(sim,&sim->leaving,r);
+}
+
+/* write the jobs and resources in each state to stderr */
+static void report(struct simulation *sim)
+{
+	sim->report_requested = 0;
+	fprintf(stderr,"%s tick %li: jobs waiting %li, sending %li, running %li, done %li",
+	    sim->policy->name,sim->now,sim->jobs_in[WAITING],sim->jobs_in[SENDING_DATA],sim->jobs_in[RUNNING],sim->jobs_in[DONE]);
+	if (sim->policy->kind == AR)
+		fprintf(stderr,", waiting to send %li, ready to run %li",
+		    sim->jobs_in[WAITING_TO_SEND_DATA],sim->jobs_in[READY_TO_RUN]);
+	fprintf(stderr,"; resources available %li, leaving %li",sim->res_in[AVAILABLE],sim->res_in[LEAVING]);
+	if (sim->policy->kind == AR)
+		fprintf(stderr,", with jobs %li, not accepting jobs %li\n",sim->res_in[HAS_JOBS],sim->res_in[NO_ACCEPT_JOBS]);
+	else
+		fprintf(stderr,", receiving data %li, used %li\n",sim->res_in[RECEIVING_DATA],sim->res_in[USED]);
+}
+
+/* add entry i at the end of a queue */
+static void queue_append(struct queue *q, int32_t *next, int32_t *prev, long int i)
+{
+	next[i] = -1;
+	prev[i] = q->last;
+	if (q->last >= 0) next[q->last] = i;
+	else q->first = i;
+	q->last = i;
+	++q->n;
+}
+
+/* add entry i to a queue kept in order of code, searching from the end */
+static void queue_insert(struct queue *q, int32_t *next, int32_t *prev, long int i, long int *code)
+{
+	long int k;
+
+	for (k=q->last;(k >= 0)&&(code[k] > code[i]);k=prev[k]);
+	prev[i] = k;
+	if (k >= 0) {
+		next[i] = next[k];
+		next[k] = i;
+	} else {
+		next[i] = q->first;
+		q->first = i;
+	}
+	if (next[i] >= 0) prev[next[i]] = i;
+	else q->last = i;
+	++q->n;
+}
+
+static void queue_remove(struct queue *q, int32_t *next, int32_t *prev, long int i)
+{
+	if (prev[i] >= 0) next[prev[i]] = next[i];
+	else q->first = next[i];
+	if (next[i] >= 0) prev[next[i]] = prev[i];
+	else q->last = prev[i];
+	--q->n;
+}
+
+/* entry i was moved in its table, with its links: relink its neighbours */
+static void queue_moved(struct queue *q, int32_t *next, int32_t *prev, long int i)
+{
+	if (prev[i] >= 0) next[prev[i]] = i;
+	else q->first = i;
+	if (next[i] >= 0) prev[next[i]] = i;
+	else q->last = i;
+}
+
+/* reserved job from was moved to index to in the table: relink the
+ * reservations of its resource, walking them to the one before it */
+static void rsv_moved(struct simulation *sim, long int from, long int to)
+{
+	long int r = sim->jobs.run_on[to];
+	long int k;
+
+	if (sim->res.first_rsv[r] == from) sim->res.first_rsv[r] = to;
+	else {
+		for (k=sim->res.first_rsv[r];sim->jobs.next_rsv[k] != from;k=sim->jobs.next_rsv[k]);
+		sim->jobs.next_rsv[k] = to;
+	}
+	if (sim->res.last_rsv[r] == from) sim->res.last_rsv[r] = to;
+}
+
+/* AR places a job on the accepting resource with the least
+ * total_workload, the first to arrive among equals. These resources
+ * are kept in a binary heap, load, each knowing its place in it, so
+ * that the changes of total_workload as jobs are placed and run cost
+ * O(log R). A resource stops accepting jobs when set NO_ACCEPT_JOBS,
+ * but once LEAVING it may take one again until traceall() removes it. */
+
+/* resource a comes before b in the load heap */
+static int lighter(struct simulation *sim, long int a, long int b)
+{
+	return (sim->res.total_workload[a] < sim->res.total_workload[b])
+	    ||((sim->res.total_workload[a] == sim->res.total_workload[b])&&(sim->res.code[a] < sim->res.code[b]));
+}
+
+static void load_insert(struct simulation *sim, long int r)
+{
+	add_index(sim,&sim->load,r);
+	load_place(sim,r,sim->load.n - 1);
+}
+
+static void load_remove(struct simulation *sim, long int r)
+{
+	long int i = sim->res.load_pos[r];
+	long int last;
+
+	if (i < 0) return;
+	last = sim->load.index[--sim->load.n];
+	sim->res.load_pos[r] = -1;
+	if (last != r) load_place(sim,last,i);
+}
+
+/* total_workload of resource r has changed */
+static void load_update(struct simulation *sim, long int r)
+{
+	long int i = sim->res.load_pos[r];
+
+	if (i >= 0) load_place(sim,r,i);
+}
+
+/* put resource r in the heap, starting from place i */
+static void load_place(struct simulation *sim, long int r, long int i)
+{
+	long int parent, child;
+
+	/* sift up */
+	while (i) {
+		parent = (i - 1)/2;
+		if (!(lighter(sim,r,sim->load.index[parent]))) break;
+		sim->load.index[i] = sim->load.index[parent];
+		sim->res.load_pos[sim->load.index[i]] = i;
+		i = parent;
+	}
+
+	/* sift down */
+	while ( (child = 2*i + 1) < sim->load.n ) {
+		if ( (child + 1 < sim->load.n)&&lighter(sim,sim->load.index[child+1],sim->load.index[child]) ) ++child;
+		if (!(lighter(sim,sim->load.index[child],r))) break;
+		sim->load.index[i] = sim->load.index[child];
+		sim->res.load_pos[sim->load.index[i]] = i;
+		i = child;
+	}
+	sim->load.index[i] = r;
+	sim->res.load_pos[r] = i;
+}
+
+/* The ticks between two events only advance counters, so instead of
+ * running the whole loop for them, skip_quiet_ticks() draws the
+ * add_remove() roll of every coming tick until one of them adds
+ * something or next_event() is reached, and then advances all the
+ * entities over the quiet ticks at once, skipping no more than limit.
+ * Returns the ticks skipped. */
+static long int skip_quiet_ticks(struct simulation *sim, int policy, long int limit)
+{
+	long int h, d;
+	int i;
+
+	h = next_event(sim,policy);
+	for (d = 0; (d < h - 1)&&(d < limit); ++d) {
+		i = 1 + ROLL(ARRIVAL,1000);
+		if ( (i <= ADD_RESOURCE_PROB) || (i > ADD_JOB_PROB) ) {
+			sim->next_roll = i;
+			break;
+		}
+	}
+	if (d) advance(sim,policy,d);
+	sim->now += d;
+	return d;
+}
+
+/* number of ticks until a job or a resource changes state,
+ * 1 meaning the coming tick, LONG_MAX if nothing will change */
+static long int next_event(struct simulation *sim, int policy)
+{
+	struct event e;
+
+	if (sim->pending) {
+		sim->pending = 0;
+		return 1;
+	}
+
+	/* schedule() will give a waiting job to a resource */
+	if ( (sim->jobs_in[WAITING])&&((policy != AR) ? sim->res_in[AVAILABLE] : sim->load.n) ) return 1;
+
+	/* transfers and runs of this tick have already ended */
+	while (fel_min(&sim->events) <= sim->now) fel_pop(&sim->events,&e);
+	if (fel_min(&sim->events) == LONG_MAX) return LONG_MAX;
+	return fel_min(&sim->events) - sim->now;
+}
+
+/* advance all jobs and resources over d quiet ticks, as d calls
+ * of run_send() would, none of them ending; with AR, a running job is
+ * always the first reservation of its resource, and a sending job
+ * the one its resource sends data to */
+static void advance(struct simulation *sim, int policy, long int d)
+{
+	long int j, r;
+
+	if (policy != AR) {
+		if ( (sim->jobs_in[SENDING_DATA])||(sim->jobs_in[RUNNING]) ) run_kernel(sim,d);
+		return;
+	}
+	for (j=0;j<sim->jobs.n;++j) {
+		switch (sim->jobs.state[j]) {
+		case SENDING_DATA:
+			sim->jobs.send_data[j] -= d;
+			break;
+		case RUNNING:
+			r = sim->jobs.run_on[j];
+			sim->jobs.workload[j] -= sim->res.level[r]*d;
+			sim->res.used_time[r] += d;
+			sim->res.total_workload[r] -= sim->res.level[r]*d;
+			load_update(sim,r);
+			break;
+		default:
+			break;
+		}
+	}
+}
@@ -0,0 +1,75 @@
+/* simulation library: a simulation of Grid scheduling, made from a
+ * configuration and stepped or run to its end in the calling process,
+ * its statistics read as it goes. A simulation holds all its state, so
+ * that many can run in one process, each on one thread at a time. */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdio.h>
+
+/* scheduling policies: */
+#define SIM_FCFS 1
+#define SIM_LWF 2
+#define SIM_MIXED 3
+#define SIM_AR 4
+
+/* what stepping a simulation returns, or -1 with errno set: */
+#define SIM_RUNNING 0 /* the steps asked for are done */
+#define SIM_DONE 1 /* max_jobs jobs are done, or the simulation was stopped */
+
+/* the parameters of a simulation (see sim.c), its policy and the
+ * backends it runs on */
+struct sim_config {
+	long int interval;
+	long int max_jobs;
+	long int record_interval;
+	long int rl_prob;
+	long int add_resource_prob;
+	long int add_job_prob;
+	long int fcfs_w;
+	long int lwf_w;
+	long int seed;
+	int policy; /* SIM_FCFS, SIM_LWF, SIM_MIXED or SIM_AR */
+	int fel; /* future event list backend, FEL_* of fel.h */
+	int jobq; /* LWF and mixed job queue backend, JOBQ_* of jobq.h */
+	int rng; /* random number generator, RNG_* of rng.h */
+	int kernel; /* FCFS, LWF and mixed job kernel, KERNEL_* of kernel.h, 0 for the best the processor runs */
+};
+
+/* a simulation as it stands */
+struct sim_stats {
+	long int now; /* current tick */
+	long int jobs_done;
+	long int job_number; /* jobs submitted */
+	long int resource_number; /* resources added */
+	long int jobs; /* jobs submitted and not yet done */
+	long int jobs_waiting;
+	long int resources; /* resources added and not yet gone */
+	long int resources_gone;
+	double mean_usage; /* of the resources gone, in percent */
+	double mean_wait_time; /* of the jobs not yet removed */
+};
+
+struct simulation;
+
+void sim_defaults(struct sim_config *c);
+int sim_set(struct sim_config *c, char *setting, char *where);
+int sim_read_config(struct sim_config *c, char *path);
+int sim_write_config(struct sim_config *c, FILE *fp);
+int sim_check(struct sim_config *c);
+int sim_policy(const char *name);
+const char *sim_policy_name(int policy);
+
+struct simulation *sim_create(struct sim_config *c);
+int sim_output(struct simulation *sim, const char *path, int format, int flags);
+void sim_on_record(struct simulation *sim, void (*record)(void *arg, struct sim_stats *st), void *arg);
+int sim_step(struct simulation *sim, long int events);
+int sim_step_ticks(struct simulation *sim, long int ticks);
+int sim_run(struct simulation *sim);
+void sim_stats(struct simulation *sim, struct sim_stats *st);
+void sim_stop(struct simulation *sim);
+void sim_request_report(struct simulation *sim);
+int sim_destroy(struct simulation *sim);
+
+#endif
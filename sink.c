@@ -0,0 +1,100 @@
+/* output sink: the file is opened once with O_APPEND (and O_TRUNC
+ * with SINK_TRUNCATE), and records go
+ * out in write()s holding whole records only, either a buffer full
+ * of them or, with SINK_ATOMIC, one at a time */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "sink.h"
+
+/* function declaration */
+static int write_all(int fd, const char *p, size_t len, size_t *done);
+
+/* returns 0 on success, -1 with errno set on failure */
+int sink_open(struct sink *s, const char *path, int flags)
+{
+	s->flags = flags;
+	s->len = 0;
+	s->buf = NULL;
+	if ( !(flags & SINK_ATOMIC)&&!(s->buf = malloc(SINK_BUFFER)) ) {
+		s->fd = -1;
+		errno = ENOMEM;
+		return -1;
+	}
+	if ( (s->fd = open(path, O_WRONLY|O_CREAT|O_APPEND|((flags & SINK_TRUNCATE) ? O_TRUNC : 0), 0644)) < 0 ) {
+		free(s->buf);
+		s->buf = NULL;
+		return -1;
+	}
+	return 0;
+}
+
+/* append a record, returns 0 on success, -1 with errno set on failure */
+int sink_write(struct sink *s, const char *record, size_t len)
+{
+	size_t n = 0;
+
+	if (s->fd < 0) {
+		errno = EBADF;
+		return -1;
+	}
+	if ( (s->flags & SINK_ATOMIC)||(len > SINK_BUFFER) ) {
+		if (sink_flush(s)) return -1;
+		return write_all(s->fd, record, len, &n);
+	}
+	if ( (s->len + len > SINK_BUFFER)&&sink_flush(s) ) return -1;
+	memcpy(s->buf + s->len, record, len);
+	s->len += len;
+	return 0;
+}
+
+/* on failure the records not written stay in the buffer */
+int sink_flush(struct sink *s)
+{
+	size_t n = 0;
+
+	if (!s->len) return 0;
+	if (write_all(s->fd, s->buf, s->len, &n)) {
+		memmove(s->buf, s->buf + n, s->len - n);
+		s->len -= n;
+		return -1;
+	}
+	s->len = 0;
+	return 0;
+}
+
+/* flush and close, returns 0 on success, -1 with errno set on failure;
+ * closing a closed sink does nothing */
+int sink_close(struct sink *s)
+{
+	int err = 0;
+
+	if (s->fd < 0) return 0;
+	if (sink_flush(s)) err = errno;
+	if ( close(s->fd)&&!err ) err = errno;
+	s->fd = -1;
+	free(s->buf);
+	s->buf = NULL;
+	if (!err) return 0;
+	errno = err;
+	return -1;
+}
+
+/* write all of p, going on after short or interrupted writes; *done
+ * counts the bytes written, also on failure */
+static int write_all(int fd, const char *p, size_t len, size_t *done)
+{
+	ssize_t n;
+
+	while (*done < len) {
+		if ( (n = write(fd, p + *done, len - *done)) < 0 ) {
+			if (errno == EINTR) continue;
+			return -1;
+		}
+		*done += n;
+	}
+	return 0;
+}
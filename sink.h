@@ -0,0 +1,29 @@
+/* output sink: records appended to a file through a large buffer,
+ * written out whole so that runs appending to the same file do not
+ * split each other's records */
+
+#ifndef SINK_H
+#define SINK_H
+
+#include <stddef.h>
+
+/* sink flags: */
+#define SINK_ATOMIC 1 /* write every record at once, unbuffered */
+#define SINK_TRUNCATE 2 /* empty the file when opening it */
+
+/* buffer size */
+#define SINK_BUFFER (1 << 20)
+
+struct sink {
+	int fd; /* -1 if closed */
+	int flags;
+	char *buf;
+	size_t len; /* bytes buffered */
+};
+
+int sink_open(struct sink *s, const char *path, int flags);
+int sink_write(struct sink *s, const char *record, size_t len);
+int sink_flush(struct sink *s);
+int sink_close(struct sink *s);
+
+#endif
@@ -0,0 +1,109 @@
+/* export binary statistics files (see stats.h) to the text layout
+ * grid-sim writes, one line per record on stdout; with -h, each run
+ * begins with a comment line giving its configuration
+ *
+ * usage: stats-export [-h] file ... */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "stats.h"
+
+/* function declaration */
+int export();
+
+int main(int argc, char *argv[])
+{
+	int headers = 0;
+	int c, i, err = 0;
+
+	while ( (c = getopt(argc,argv,"h")) != -1 ) {
+		if (c != 'h') {
+			fprintf(stderr,"usage: %s [-h] file ...\n",argv[0]);
+			exit(EINVAL);
+		}
+		headers = 1;
+	}
+	for (i=optind;i<argc;++i)
+		if (export(argv[i],headers)) err = 1;
+	return err;
+}
+
+/* returns 0 on success, 1 after reporting an error */
+int export(char *path, int headers)
+{
+	struct stats_header *h;
+	struct stats_block *b;
+	struct stat st;
+	const char *data;
+	const int64_t *jobs_done, *job_number;
+	const double *mean_usage, *mean_wait_time;
+	size_t off, column, size;
+	uint32_t i;
+	int fd;
+
+	if ( ((fd = open(path,O_RDONLY)) < 0)||fstat(fd,&st) ) {
+		perror(path);
+		return 1;
+	}
+	if (!(size = (size_t)st.st_size)) {
+		close(fd);
+		return 0;
+	}
+	if ( (data = mmap(NULL,size,PROT_READ,MAP_PRIVATE,fd,0)) == MAP_FAILED ) {
+		perror(path);
+		close(fd);
+		return 1;
+	}
+	close(fd);
+
+	for (off=0;off<size;) {
+		/* a run begins */
+		if ( (off + sizeof(struct stats_header) <= size)
+		    &&!memcmp(data + off,STATS_MAGIC,sizeof(h->magic)) ) {
+			h = (struct stats_header *)(data + off);
+			if ( (h->byte_order != STATS_BYTE_ORDER)||(h->version != STATS_VERSION) ) {
+				fprintf(stderr,"%s: run at byte %zu: other byte order or version\n",path,off);
+				break;
+			}
+			if (headers)
+				printf("# %.16s seed %lli interval %lli max_jobs %lli record_interval %lli"
+				    " rl_prob %lli add_resource_prob %lli add_job_prob %lli fcfs_w %lli lwf_w %lli\n",
+				    h->policy,(long long)h->seed,(long long)h->interval,(long long)h->max_jobs,
+				    (long long)h->record_interval,(long long)h->rl_prob,(long long)h->add_resource_prob,
+				    (long long)h->add_job_prob,(long long)h->fcfs_w,(long long)h->lwf_w);
+			off += sizeof(struct stats_header);
+			continue;
+		}
+
+		/* a block of records */
+		b = (struct stats_block *)(data + off);
+		if ( (off + sizeof(struct stats_block) > size)
+		    ||memcmp(b->magic,STATS_BLOCK_MAGIC,sizeof(b->magic)) ) {
+			fprintf(stderr,"%s: byte %zu: no run or block here\n",path,off);
+			break;
+		}
+		column = b->rows*sizeof(int64_t);
+		if (off + sizeof(struct stats_block) + 4*column > size) {
+			fprintf(stderr,"%s: byte %zu: block cut short\n",path,off);
+			break;
+		}
+		jobs_done = (const int64_t *)(b + 1);
+		mean_usage = (const double *)(jobs_done + b->rows);
+		mean_wait_time = mean_usage + b->rows;
+		job_number = (const int64_t *)(mean_wait_time + b->rows);
+		for (i=0;i<b->rows;++i)
+			printf("%li %f %f %li\n",(long int)jobs_done[i],mean_usage[i],mean_wait_time[i],(long int)job_number[i]);
+		off += sizeof(struct stats_block) + 4*column;
+	}
+
+	munmap((void *)data,size);
+	if (off < size) return 1;
+	return 0;
+}
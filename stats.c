@@ -0,0 +1,120 @@
+/* statistics files, text or binary (see stats.h), through a sink */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "stats.h"
+
+/* function declaration */
+static int write_block(struct stats_file *f);
+
+int stats_format(const char *name)
+{
+	if (!strcmp(name,"text")) return STATS_TEXT;
+	if (!strcmp(name,"binary")) return STATS_BINARY;
+	return 0;
+}
+
+/* open for appending, the binary header is filled in with its magic
+ * and written first; returns 0 on success, -1 with errno set on failure */
+int stats_open(struct stats_file *f, const char *path, int format, int flags, struct stats_header *h)
+{
+	memset(f, 0, sizeof(struct stats_file));
+	f->sink.fd = -1;
+	f->format = format;
+	if (format == STATS_BINARY) {
+		f->jobs_done = malloc(STATS_BLOCK*sizeof(int64_t));
+		f->mean_usage = malloc(STATS_BLOCK*sizeof(double));
+		f->mean_wait_time = malloc(STATS_BLOCK*sizeof(double));
+		f->job_number = malloc(STATS_BLOCK*sizeof(int64_t));
+		if ( !(f->jobs_done)||!(f->mean_usage)||!(f->mean_wait_time)||!(f->job_number) ) {
+			stats_close(f);
+			errno = ENOMEM;
+			return -1;
+		}
+	}
+	if (sink_open(&f->sink, path, flags)) {
+		stats_close(f);
+		return -1;
+	}
+	if (format != STATS_BINARY) return 0;
+
+	memcpy(h->magic, STATS_MAGIC, sizeof(h->magic));
+	h->byte_order = STATS_BYTE_ORDER;
+	h->version = STATS_VERSION;
+	if (sink_write(&f->sink, (char *)h, sizeof(struct stats_header))) {
+		stats_close(f);
+		return -1;
+	}
+	return 0;
+}
+
+/* returns 0 on success, -1 with errno set on failure */
+int stats_record(struct stats_file *f, long int jobs_done, double mean_usage, double mean_wait_time, long int job_number)
+{
+	char line[128];
+	int len;
+
+	if (f->format != STATS_BINARY) {
+		len = snprintf(line,sizeof(line),"%li %f %f %li\n",jobs_done,mean_usage,mean_wait_time,job_number);
+		if ( (len < 0)||((size_t)len >= sizeof(line)) ) {
+			errno = EOVERFLOW;
+			return -1;
+		}
+		return sink_write(&f->sink, line, len);
+	}
+
+	f->jobs_done[f->rows] = jobs_done;
+	f->mean_usage[f->rows] = mean_usage;
+	f->mean_wait_time[f->rows] = mean_wait_time;
+	f->job_number[f->rows] = job_number;
+	++f->rows;
+	if ( (f->rows == STATS_BLOCK)||(f->sink.flags & SINK_ATOMIC) ) return write_block(f);
+	return 0;
+}
+
+/* write what is left and close; returns 0 on success, -1 with errno
+ * set on failure */
+int stats_close(struct stats_file *f)
+{
+	int err = 0;
+
+	if ( (f->sink.fd >= 0)&&(f->rows)&&write_block(f) ) err = errno;
+	if ( sink_close(&f->sink)&&!err ) err = errno;
+	free(f->jobs_done);
+	free(f->mean_usage);
+	free(f->mean_wait_time);
+	free(f->job_number);
+	memset(f, 0, sizeof(struct stats_file));
+	f->sink.fd = -1;
+	if (!err) return 0;
+	errno = err;
+	return -1;
+}
+
+/* the records kept go out as one block, in a single sink record */
+static int write_block(struct stats_file *f)
+{
+	struct stats_block *b;
+	char *p;
+	size_t column = f->rows*sizeof(int64_t);
+	size_t len = sizeof(struct stats_block) + 4*column;
+	int ret;
+
+	if ( !(p = malloc(len)) ) {
+		errno = ENOMEM;
+		return -1;
+	}
+	b = (struct stats_block *)p;
+	memcpy(b->magic, STATS_BLOCK_MAGIC, sizeof(b->magic));
+	b->rows = f->rows;
+	memcpy(p + sizeof(struct stats_block), f->jobs_done, column);
+	memcpy(p + sizeof(struct stats_block) + column, f->mean_usage, column);
+	memcpy(p + sizeof(struct stats_block) + 2*column, f->mean_wait_time, column);
+	memcpy(p + sizeof(struct stats_block) + 3*column, f->job_number, column);
+	f->rows = 0;
+	ret = sink_write(&f->sink, p, len);
+	free(p);
+	return ret;
+}
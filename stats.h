@@ -0,0 +1,70 @@
+/* statistics files: a record every RECORD_INTERVAL jobs done, written
+ * as text lines or in a binary format of column blocks
+ *
+ * The binary format, in the byte order of the writer: a struct
+ * stats_header, then blocks of up to STATS_BLOCK records, each a
+ * struct stats_block followed by the columns, rows values each:
+ * jobs_done (int64), mean_usage (double), mean_wait_time (double),
+ * job_number (int64). A file may hold several runs one after the
+ * other, each beginning with its header. */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include "sink.h"
+
+/* statistics formats: */
+#define STATS_TEXT 1
+#define STATS_BINARY 2
+
+/* records in a binary block */
+#define STATS_BLOCK 4096
+
+#define STATS_MAGIC "GRIDSTAT"
+#define STATS_BLOCK_MAGIC "BLCK"
+#define STATS_BYTE_ORDER 0x01020304
+#define STATS_VERSION 2
+
+/* run configuration, 120 bytes */
+struct stats_header {
+	char magic[8]; /* STATS_MAGIC */
+	uint32_t byte_order; /* STATS_BYTE_ORDER */
+	uint32_t version; /* STATS_VERSION */
+	char policy[16];
+	int64_t seed;
+	int64_t interval;
+	int64_t max_jobs;
+	int64_t record_interval;
+	int64_t rl_prob;
+	int64_t add_resource_prob;
+	int64_t add_job_prob;
+	int64_t fcfs_w;
+	int64_t lwf_w;
+	int32_t fel; /* future event list backend */
+	int32_t jobq; /* job queue backend */
+	int32_t rng; /* random number generator */
+	int32_t unused;
+};
+
+struct stats_block {
+	char magic[4]; /* STATS_BLOCK_MAGIC */
+	uint32_t rows;
+};
+
+struct stats_file {
+	int format;
+	struct sink sink;
+	uint32_t rows; /* records not yet written, binary */
+	int64_t *jobs_done;
+	double *mean_usage;
+	double *mean_wait_time;
+	int64_t *job_number;
+};
+
+int stats_format(const char *name);
+int stats_open(struct stats_file *f, const char *path, int format, int flags, struct stats_header *h);
+int stats_record(struct stats_file *f, long int jobs_done, double mean_usage, double mean_wait_time, long int job_number);
+int stats_close(struct stats_file *f);
+
+#endif
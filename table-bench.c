@@ -0,0 +1,244 @@
+/* job layout benchmark: ticks per second of the full passes a tick
+ * makes over the jobs (traceall(), remove_done_jobs(), run_send() and
+ * the FCFS search for the first waiting job), with the jobs in a
+ * linked list of separately allocated nodes as grid-sim.c had them,
+ * and in the tables of columns it has now
+ *
+ * usage: table-bench [live jobs ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* job states: */
+#define WAITING 1
+#define RUNNING 2
+#define DONE 3
+#define SENDING_DATA 4
+
+/* one job in RUNNING_EVERY runs or sends, the others wait */
+#define RUNNING_EVERY 20
+
+/* ticks timed, scaled down with the number of jobs */
+#define TICK_JOBS 50000000L
+
+struct job {
+	long int code;
+	int state;
+	int workload;
+	int send_data;
+	long int wait_time;
+	struct job *next;
+	struct resource *run_on;
+};
+
+struct resource {
+	long int code;
+	int state;
+	int level;
+	float total_time;
+	float used_time;
+	struct resource *next;
+};
+
+struct job_table {
+	long int n;
+	long int *code;
+	int *state;
+	int *workload;
+	int *send_data;
+	long int *wait_time;
+	long int *run_on;
+};
+
+/* function declaration */
+double list_ticks();
+double table_ticks();
+double seconds();
+int initial_state();
+
+/* kept so the compiler cannot drop the passes */
+long int sink = 0;
+
+int main(int argc, char *argv[])
+{
+	static long int sizes[] = { 10000, 100000, 1000000 };
+	double before, after;
+	long int n;
+	int i, count;
+
+	count = (argc > 1) ? argc - 1 : 3;
+	printf("%10s %14s %14s %8s\n", "live jobs", "list ticks/s", "table ticks/s", "speedup");
+	for (i=0;i<count;++i) {
+		n = (argc > 1) ? atol(argv[i+1]) : sizes[i];
+		before = list_ticks(n);
+		after = table_ticks(n);
+		printf("%10li %14.1f %14.1f %7.1fx\n", n, before, after, after/before);
+	}
+	return sink ? 0 : 1;
+}
+
+double seconds()
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+/* state of the i-th job: mostly waiting, a few sending or running */
+int initial_state(long int i)
+{
+	if (i % RUNNING_EVERY) return WAITING;
+	return (i/RUNNING_EVERY % 2) ? RUNNING : SENDING_DATA;
+}
+
+double list_ticks(long int n)
+{
+	struct job **node, *first, *j;
+	struct resource *res;
+	long int i, k, ticks, done, t;
+	double t0;
+
+	/* nodes allocated one by one and linked in a shuffled order,
+	 * as they end up after many jobs have come and gone */
+	node = malloc(n*sizeof(struct job *));
+	res = malloc((n/RUNNING_EVERY + 1)*sizeof(struct resource));
+	for (i=0;i<n;++i) node[i] = malloc(sizeof(struct job));
+	srandom(1);
+	for (i=n-1;i>0;--i) {
+		k = random() % (i + 1);
+		j = node[i];
+		node[i] = node[k];
+		node[k] = j;
+	}
+	for (i=0;i<n;++i) {
+		j = node[i];
+		j->code = i + 1;
+		j->state = initial_state(i);
+		j->workload = 50 + i % 950;
+		j->send_data = i % 30;
+		j->wait_time = 0;
+		j->run_on = &res[i/RUNNING_EVERY];
+		j->next = (i + 1 < n) ? node[i+1] : NULL;
+		res[i/RUNNING_EVERY].level = 1 + i % 5;
+		res[i/RUNNING_EVERY].used_time = 0;
+		res[i/RUNNING_EVERY].total_time = 0;
+	}
+	first = node[0];
+
+	ticks = TICK_JOBS/n;
+	t0 = seconds();
+	for (t=0;t<ticks;++t) {
+		/* traceall() */
+		done = 0;
+		for (j=first;j;j=j->next)
+			if (j->state == WAITING) j->wait_time++;
+			else if (j->state == DONE) ++done;
+
+		/* remove_done_jobs(), finding nothing to remove */
+		for (j=first;j;j=j->next)
+			if (j->state == DONE) ++done;
+
+		/* run_send(), restarting ended jobs to keep the population */
+		for (j=first;j;j=j->next)
+			switch (j->state) {
+			case SENDING_DATA:
+				if (--j->send_data <= 0) j->send_data = 30;
+				break;
+			case RUNNING:
+				j->workload -= j->run_on->level;
+				j->run_on->used_time++;
+				if (j->workload <= 0) j->workload = 999;
+				break;
+			}
+
+		/* schedule(): first waiting job, behind the running ones */
+		for (j=first;j;j=j->next)
+			if ( (j->state == WAITING)&&(j->code > n/2) ) break;
+		sink += done + (j ? j->code : 0);
+	}
+	t0 = seconds() - t0;
+
+	for (i=0;i<n;++i) free(node[i]);
+	free(node);
+	free(res);
+	return ticks/t0;
+}
+
+double table_ticks(long int n)
+{
+	struct job_table jobs;
+	int *level;
+	float *used_time;
+	long int i, j, r, ticks, done, t, first;
+	double t0;
+
+	jobs.n = n;
+	jobs.code = malloc(n*sizeof(long int));
+	jobs.state = malloc(n*sizeof(int));
+	jobs.workload = malloc(n*sizeof(int));
+	jobs.send_data = malloc(n*sizeof(int));
+	jobs.wait_time = malloc(n*sizeof(long int));
+	jobs.run_on = malloc(n*sizeof(long int));
+	level = malloc((n/RUNNING_EVERY + 1)*sizeof(int));
+	used_time = malloc((n/RUNNING_EVERY + 1)*sizeof(float));
+	for (i=0;i<n;++i) {
+		jobs.code[i] = i + 1;
+		jobs.state[i] = initial_state(i);
+		jobs.workload[i] = 50 + i % 950;
+		jobs.send_data[i] = i % 30;
+		jobs.wait_time[i] = 0;
+		jobs.run_on[i] = i/RUNNING_EVERY;
+		level[i/RUNNING_EVERY] = 1 + i % 5;
+		used_time[i/RUNNING_EVERY] = 0;
+	}
+
+	ticks = TICK_JOBS/n;
+	t0 = seconds();
+	for (t=0;t<ticks;++t) {
+		/* traceall() */
+		done = 0;
+		for (j=0;j<jobs.n;++j) {
+			jobs.wait_time[j] += (jobs.state[j] == WAITING);
+			done += (jobs.state[j] == DONE);
+		}
+
+		/* remove_done_jobs(), finding nothing to remove */
+		for (j=0;j<jobs.n;++j)
+			done += (jobs.state[j] == DONE);
+
+		/* run_send(), restarting ended jobs to keep the population */
+		for (j=0;j<jobs.n;++j)
+			switch (jobs.state[j]) {
+			case SENDING_DATA:
+				if (--jobs.send_data[j] <= 0) jobs.send_data[j] = 30;
+				break;
+			case RUNNING:
+				r = jobs.run_on[j];
+				jobs.workload[j] -= level[r];
+				used_time[r]++;
+				if (jobs.workload[j] <= 0) jobs.workload[j] = 999;
+				break;
+			}
+
+		/* schedule(): first waiting job by code, over the whole table */
+		first = -1;
+		for (j=0;j<jobs.n;++j)
+			if ( (jobs.state[j] == WAITING)&&(jobs.code[j] > n/2)
+			    &&((first < 0)||(jobs.code[j] < jobs.code[first])) )
+				first = j;
+		sink += done + first;
+	}
+	t0 = seconds() - t0;
+
+	free(jobs.code);
+	free(jobs.state);
+	free(jobs.workload);
+	free(jobs.send_data);
+	free(jobs.wait_time);
+	free(jobs.run_on);
+	free(level);
+	free(used_time);
+	return ticks/t0;
+}
@@ -0,0 +1,221 @@
+/* tick pass benchmark: ticks per second and bytes read per tick of
+ * the passes FCFS, LWF and mixed make over the jobs, with the jobs done
+ * last tick removed in a pass of their own before run_send(), as
+ * remove_done_jobs() first did, in the run_send() pass itself, and from
+ * a list of the jobs set DONE, highest index first, without a pass, as
+ * sim.c does now. A few jobs end every tick, and each removed job is
+ * replaced by a new one, to keep the number of live jobs.
+ *
+ * usage: tick-bench [live jobs ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* job states: */
+#define WAITING 1
+#define RUNNING 2
+#define DONE 3
+#define SENDING_DATA 4
+
+/* one job in RUNNING_EVERY runs or sends, the others wait */
+#define RUNNING_EVERY 20
+
+/* ticks timed, scaled down with the number of jobs */
+#define TICK_JOBS 50000000L
+
+/* ways of removing the done jobs: */
+#define SCAN 0 /* a pass of their own */
+#define FUSED 1 /* in run_send() */
+#define LISTED 2 /* from the list of jobs set DONE */
+
+struct job_table {
+	long int n;
+	long int *code;
+	int *state;
+	int *workload;
+	int *send_data;
+	long int *run_on;
+	long int *done; /* jobs set DONE, if LISTED */
+	long int ndone;
+};
+
+/* function declaration */
+double ticks_per_second();
+void make_jobs();
+void free_jobs();
+void remove_job();
+long int run_send();
+void remove_listed();
+double seconds();
+
+/* kept so the compiler cannot drop the passes */
+long int sink = 0;
+
+/* bytes read by the passes of the last run */
+double bytes;
+
+int main(int argc, char *argv[])
+{
+	static long int sizes[] = { 10000, 100000, 1000000 };
+	static char *names[] = { "2 passes", "fused", "listed" };
+	double ticks[3], read[3];
+	long int n;
+	int i, w, count;
+
+	count = (argc > 1) ? argc - 1 : 3;
+	printf("%10s %10s %14s %8s %10s\n", "live jobs", "removal", "ticks/s", "speedup", "B/tick");
+	for (i=0;i<count;++i) {
+		n = (argc > 1) ? atol(argv[i+1]) : sizes[i];
+		for (w=SCAN;w<=LISTED;++w) {
+			ticks[w] = ticks_per_second(n,w);
+			read[w] = bytes;
+			printf("%10li %10s %14.1f %7.1fx %10.0f\n", n, names[w], ticks[w], ticks[w]/ticks[SCAN], read[w]);
+		}
+	}
+	return sink ? 0 : 1;
+}
+
+double seconds()
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+/* n jobs, mostly waiting, a few sending or running, with room for
+ * the ones added */
+void make_jobs(struct job_table *jobs, long int n, int **level)
+{
+	long int i;
+
+	jobs->n = n;
+	jobs->code = malloc(2*n*sizeof(long int));
+	jobs->state = malloc(2*n*sizeof(int));
+	jobs->workload = malloc(2*n*sizeof(int));
+	jobs->send_data = malloc(2*n*sizeof(int));
+	jobs->run_on = malloc(2*n*sizeof(long int));
+	jobs->done = malloc(2*n*sizeof(long int));
+	jobs->ndone = 0;
+	*level = malloc((n/RUNNING_EVERY + 1)*sizeof(int));
+	for (i=0;i<n;++i) {
+		jobs->code[i] = i + 1;
+		jobs->state[i] = (i % RUNNING_EVERY) ? WAITING : (i/RUNNING_EVERY % 2) ? RUNNING : SENDING_DATA;
+		jobs->workload[i] = 50 + i % 950;
+		jobs->send_data[i] = i % 30;
+		jobs->run_on[i] = i/RUNNING_EVERY;
+		(*level)[i/RUNNING_EVERY] = 1 + i % 5;
+	}
+}
+
+void free_jobs(struct job_table *jobs, int *level)
+{
+	free(jobs->code);
+	free(jobs->state);
+	free(jobs->workload);
+	free(jobs->send_data);
+	free(jobs->run_on);
+	free(jobs->done);
+	free(level);
+}
+
+/* move the last job into j */
+void remove_job(struct job_table *jobs, long int j)
+{
+	long int last = --jobs->n;
+
+	jobs->code[j] = jobs->code[last];
+	jobs->state[j] = jobs->state[last];
+	jobs->workload[j] = jobs->workload[last];
+	jobs->send_data[j] = jobs->send_data[last];
+	jobs->run_on[j] = jobs->run_on[last];
+}
+
+/* remove the listed jobs, highest index first, so that the job moved
+ * into a freed place is never one still to remove */
+void remove_listed(struct job_table *jobs)
+{
+	long int i, k, x;
+
+	for (i=1;i<jobs->ndone;++i) {
+		x = jobs->done[i];
+		for (k=i;(k > 0)&&(jobs->done[k-1] < x);--k)
+			jobs->done[k] = jobs->done[k-1];
+		jobs->done[k] = x;
+	}
+	for (i=0;i<jobs->ndone;++i)
+		remove_job(jobs,jobs->done[i]);
+	bytes += jobs->ndone*sizeof(long int);
+	jobs->ndone = 0;
+}
+
+/* advance the sending and running jobs, removing those done last tick
+ * if FUSED and listing those done now if LISTED; returns the jobs done */
+long int run_send(struct job_table *jobs, int *level, int way)
+{
+	long int j, done = 0;
+
+	for (j=0;j<jobs->n;++j)
+		switch (jobs->state[j]) {
+		case DONE:
+			if (way == FUSED) remove_job(jobs,j--);
+			break;
+		case SENDING_DATA:
+			if (--jobs->send_data[j] <= 0) jobs->state[j] = RUNNING;
+			bytes += sizeof(int);
+			break;
+		case RUNNING:
+			jobs->workload[j] -= level[jobs->run_on[j]];
+			if (jobs->workload[j] <= 0) {
+				jobs->state[j] = DONE;
+				if (way == LISTED) jobs->done[jobs->ndone++] = j;
+				++done;
+			}
+			bytes += sizeof(int) + sizeof(long int) + sizeof(int);
+			break;
+		}
+	bytes += jobs->n*sizeof(int);
+	return done;
+}
+
+double ticks_per_second(long int n, int way)
+{
+	struct job_table jobs;
+	int *level;
+	long int i, j, ticks, t, done = 0, code = n;
+	double t0;
+
+	make_jobs(&jobs,n,&level);
+	ticks = TICK_JOBS/n;
+	bytes = 0;
+	t0 = seconds();
+	for (t=0;t<ticks;++t) {
+		/* remove_done_jobs() */
+		if ( (way == SCAN)&&done ) {
+			for (j=0;j<jobs.n;)
+				if (jobs.state[j] == DONE) remove_job(&jobs,j);
+				else ++j;
+			bytes += jobs.n*sizeof(int);
+		}
+		if (way == LISTED) remove_listed(&jobs);
+
+		/* new jobs, to send and run, in place of the removed ones */
+		for (i=0;i<done;++i) {
+			j = jobs.n++;
+			jobs.code[j] = ++code;
+			jobs.state[j] = SENDING_DATA;
+			jobs.workload[j] = 50 + code % 950;
+			jobs.send_data[j] = code % 30;
+			jobs.run_on[j] = code % (n/RUNNING_EVERY + 1);
+		}
+
+		done = run_send(&jobs,level,way);
+		sink += done + jobs.n;
+	}
+	t0 = seconds() - t0;
+	bytes /= ticks;
+
+	free_jobs(&jobs,level);
+	return ticks/t0;
+}